@@ -1,29 +1,668 @@
 #ifndef BST_BST_H
 #define BST_BST_H
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <initializer_list>
 #include <iterator>
+#include <limits>
 #include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <ratio>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "detail/tree_algorithms.h"
+
+#if __has_include(<memory_resource>)
+#include <memory_resource>
+#define BST_HAS_MEMORY_RESOURCE 1
+#else
+#define BST_HAS_MEMORY_RESOURCE 0
+#endif
+
+namespace bst {
+
+/**
+ * @brief Balancing policy that keeps the plain Binary Search Tree behaviour.
+ *
+ * Nodes carry no extra metadata and the tree never restructures itself, so
+ * operation costs depend on insertion order. This is the default policy.
+ */
+struct no_balance {};
+
+/**
+ * @brief Balancing policy that maintains AVL height invariants.
+ *
+ * Every node stores its subtree height and the tree rotates on insert and
+ * erase so that sibling heights never differ by more than one. The height of
+ * the tree stays below roughly `1.44 log2(N + 2)` for any insertion order.
+ */
+struct avl_balance {};
+
+/**
+ * @brief Balancing policy that maintains red-black colour invariants.
+ *
+ * Every node stores one colour flag. Insert performs at most two rotations
+ * and erase at most three, which makes this policy a better fit than AVL for
+ * write-heavy workloads with frequent erasure. The height of the tree stays
+ * below `2 log2(N + 1)`.
+ */
+struct red_black_balance {};
+
+/**
+ * @brief Balancing policy that splays accessed nodes to the root.
+ *
+ * `insert`, `find`, and `lower_bound` on a non-const tree rotate the node
+ * they return (or the last node visited on a miss) to the root, and
+ * `erase` splays the parent of the removed slot. Recently used keys
+ * therefore stay near the top, which suits skewed access patterns. Nodes
+ * carry no extra metadata, and these splaying operations cost amortized
+ * `O(log N)`.
+ *
+ * @note
+ * `contains`, `upper_bound`, and lookups through a const tree do not
+ * restructure the tree, so they cost `O(h)` in the current height, which
+ * can reach `N`.
+ */
+struct splay_balance {};
+
+/**
+ * @brief Balancing policy that keeps a randomized treap.
+ *
+ * Every node stores a random priority and its subtree size. Insert and erase
+ * rotate so that priorities form a max-heap, which keeps the expected height
+ * logarithmic for any insertion order. Treap trees also support `split()` and
+ * `join()` in expected `O(log N)`.
+ */
+struct treap_balance {};
+
+/**
+ * @brief Balancing policy that keeps a scapegoat tree.
+ *
+ * Nodes carry no metadata at all; the tree only tracks the largest size it
+ * reached since its last full rebuild. When an insertion lands deeper than
+ * `log_{1/alpha}(N)` the tree finds the ancestor whose subtree is out of
+ * `alpha` weight balance and rebuilds that subtree into perfect balance. Erase
+ * rebuilds the whole tree once enough elements were removed. Insert and
+ * erase cost amortized `O(log N)` and lookups worst-case `O(log N)`.
+ *
+ * @tparam Alpha Weight-balance factor as a `std::ratio` in `(1/2, 1)`.
+ *         Smaller values keep the tree shorter at the cost of more rebuilds.
+ */
+template <typename Alpha = std::ratio<2, 3>>
+struct scapegoat_balance {
+    static_assert(Alpha::num * 2 > Alpha::den && Alpha::num < Alpha::den,
+                  "scapegoat_balance: alpha must lie strictly between 1/2 and 1");
+
+    using alpha = Alpha;
+};
+
+/**
+ * @brief Policy wrapper that adds in-order threads to another balancing policy.
+ *
+ * Every node additionally stores pointers to its in-order predecessor and
+ * successor, kept up to date by insert, erase, and the bulk operations.
+ * Rotations and rebuilds never change in-order order, so balancing does not
+ * touch them. Iterator increment and decrement then cost worst-case `O(1)`
+ * and a full scan is a linked-list walk, at 16 extra bytes per node.
+ *
+ * @tparam Balance Wrapped policy, e.g. `bst::avl_balance`.
+ */
+template <typename Balance = no_balance>
+struct threaded {
+    using base = Balance;
+};
+
+/**
+ * @brief Policy wrapper that adds subtree sizes to another balancing policy.
+ *
+ * Every node additionally stores the number of nodes in its subtree, kept up
+ * to date by insert, erase, rotations, and rebuilds at constant extra work
+ * per level. `nth()`, `rank()`, and `distance()` then descend the tree
+ * instead of counting elements, at 8 extra bytes per node.
+ * `bst::treap_balance` already stores these sizes and needs no wrapper.
+ *
+ * Combines with `bst::threaded` in either order.
+ *
+ * @tparam Balance Wrapped policy, e.g. `bst::red_black_balance`.
+ */
+template <typename Balance = no_balance>
+struct order_statistics {
+    using base = Balance;
+};
+
+/**
+ * @brief Policy wrapper that caches an aggregate of every subtree in its root.
+ *
+ * `Aggregate` describes a monoid over a projection of the stored values, as
+ * static members:
+ *
+ * - `value_type`: the aggregate type, default-constructible and copyable.
+ * - `static value_type identity()`: the neutral element.
+ * - `static value_type project(const T&)`: the contribution of one element.
+ * - `static value_type combine(const value_type& lhs, const value_type& rhs)`:
+ *   an associative operation; `lhs` covers the smaller elements.
+ *
+ * None of them may throw. Insert and erase recompute the aggregates along the
+ * changed path and rotations refresh the two nodes they move, so
+ * `aggregate(lo, hi)` combines `O(log N)` cached values instead of visiting
+ * the range.
+ *
+ * Combines with `bst::threaded` and `bst::order_statistics` in any order.
+ *
+ * @tparam Aggregate Monoid description, e.g. a sum of quantities.
+ * @tparam Balance Wrapped policy, e.g. `bst::red_black_balance`.
+ */
+template <typename Aggregate, typename Balance = no_balance>
+struct augmented {
+    using base = Balance;
+    using aggregate = Aggregate;
+};
+
+/**
+ * @brief Reads the endpoints of a half-open interval `[lower, upper)`.
+ *
+ * The primary template reads `std::pair`-like values through `first` and
+ * `second`; specialize it, or pass a type with the same members to
+ * `bst::max_upper_endpoint`, for other interval types.
+ *
+ * @tparam Interval Stored interval type.
+ */
+template <typename Interval>
+struct interval_traits {
+    using endpoint_type = typename Interval::first_type;
+
+    static const endpoint_type& lower(const Interval& interval) noexcept {
+        return interval.first;
+    }
+
+    static const endpoint_type& upper(const Interval& interval) noexcept {
+        return interval.second;
+    }
+};
+
+/**
+ * @brief Aggregate for `bst::augmented` that caches the largest upper
+ * endpoint of every subtree, which turns the tree into an interval tree.
+ *
+ * With it, `for_each_overlapping()` and `overlapping()` skip every subtree
+ * whose intervals all end at or before the query. The tree's comparator
+ * must order intervals by lower endpoint first. Endpoints must be
+ * arithmetic, or have a `std::numeric_limits` specialization.
+ *
+ * @tparam Interval Stored interval type.
+ * @tparam Traits Endpoint accessors, as in `bst::interval_traits`.
+ */
+template <typename Interval, typename Traits = interval_traits<Interval>>
+struct max_upper_endpoint {
+    using traits = Traits;
+    using value_type = typename Traits::endpoint_type;
+
+    static_assert(std::numeric_limits<value_type>::is_specialized,
+                  "bst::max_upper_endpoint requires endpoints with std::numeric_limits");
+
+    static value_type identity() noexcept {
+        return std::numeric_limits<value_type>::lowest();
+    }
+
+    static value_type project(const Interval& interval) noexcept {
+        return Traits::upper(interval);
+    }
+
+    static value_type combine(const value_type& lhs, const value_type& rhs) noexcept {
+        return lhs < rhs ? rhs : lhs;
+    }
+};
+
+/**
+ * @brief Tag type marking input that is already sorted and free of duplicates.
+ */
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+
+/**
+ * @brief Tag value selecting the `O(N)` bulk-construction overloads.
+ */
+inline constexpr sorted_unique_t sorted_unique{};
+
+/**
+ * @brief Value a traversal callback may return to end the traversal early.
+ *
+ * Callbacks that return `void` always visit every element; callbacks that
+ * return `bst::visit` stop as soon as they return `bst::visit::stop`.
+ */
+enum class visit { proceed, stop };
+
+namespace detail {
+
+// Calls a traversal callback and reports whether the traversal should go on.
+template <typename Visitor, typename Value>
+bool keep_visiting(Visitor& visitor, const Value& value) {
+    if constexpr (std::is_same<decltype(visitor(value)), visit>::value) {
+        return visitor(value) == visit::proceed;
+    } else {
+        visitor(value);
+        return true;
+    }
+}
+
+template <typename Balance>
+struct balance_node_data {};
+
+// Peels the `threaded`, `order_statistics`, and `augmented` wrappers, in any
+// order, off a balancing policy.
+template <typename Balance>
+struct policy_traits {
+    using base = Balance;
+    using aggregate = void;
+    static constexpr bool has_threads = false;
+    static constexpr bool has_counts = false;
+};
+
+template <typename Balance>
+struct policy_traits<threaded<Balance>> : policy_traits<Balance> {
+    static constexpr bool has_threads = true;
+};
+
+template <typename Balance>
+struct policy_traits<order_statistics<Balance>> : policy_traits<Balance> {
+    static constexpr bool has_counts = true;
+};
+
+template <typename Aggregate, typename Balance>
+struct policy_traits<augmented<Aggregate, Balance>> : policy_traits<Balance> {
+    using aggregate = Aggregate;
+};
+
+template <typename Node, bool Threaded>
+struct thread_node_data {};
+
+template <typename Node>
+struct thread_node_data<Node, true> {
+    Node* prev = nullptr;
+    Node* next = nullptr;
+};
+
+template <typename Balance>
+struct is_scapegoat_balance : std::false_type {};
+
+template <typename Alpha>
+struct is_scapegoat_balance<scapegoat_balance<Alpha>> : std::true_type {};
+
+template <>
+struct balance_node_data<avl_balance> {
+    // AVL heights never exceed ~1.44 log2(N), so a byte is plenty.
+    unsigned char height = 1;
+};
+
+template <>
+struct balance_node_data<red_black_balance> {
+    // New nodes are linked in red; the insert fixup repaints as needed.
+    bool red = true;
+};
+
+inline std::uint32_t next_treap_priority() noexcept {
+    // xorshift32 keeps priority generation cheap; each thread is seeded once.
+    thread_local std::uint32_t state = [] {
+        std::random_device device;
+        const std::uint32_t seed = device();
+        return seed != 0 ? seed : 0x9e3779b9u;
+    }();
+
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+template <>
+struct balance_node_data<treap_balance> {
+    std::uint32_t priority = next_treap_priority();
+    // Subtree size, so split() can size both halves without a walk.
+    std::size_t count = 1;
+};
+
+template <bool Counted>
+struct count_node_data {};
+
+template <>
+struct count_node_data<true> {
+    std::size_t count = 1;
+};
+
+template <typename Aggregate>
+struct aggregate_node_data {
+    typename Aggregate::value_type summary = Aggregate::identity();
+};
+
+template <>
+struct aggregate_node_data<void> {};
+
+template <typename Aggregate>
+struct aggregate_value {
+    using type = typename Aggregate::value_type;
+};
+
+template <typename Aggregate>
+struct is_interval_aggregate : std::false_type {};
+
+template <typename Interval, typename Traits>
+struct is_interval_aggregate<max_upper_endpoint<Interval, Traits>> : std::true_type {};
+
+template <>
+struct aggregate_value<void> {
+    using type = void;
+};
+
+// Everything a node caches besides its links: the policy's balance data,
+// with `order_statistics` the subtree size, and with `augmented` the
+// subtree aggregate. Treaps already keep the size. The size comes first so a
+// one-byte height or colour, and small values, pack into the padding after
+// it.
+template <typename Balance, bool Counted, typename Aggregate>
+struct node_metadata : count_node_data<Counted && !std::is_same<Balance, treap_balance>::value>,
+                       balance_node_data<Balance>,
+                       aggregate_node_data<Aggregate> {};
+
+// Block pool shared by every copy of a `bst::pool_allocator`. Each block size
+// (rounded up to `max_align_t`) gets its own free list, so rebound copies that
+// allocate different types draw from separate lists of the same pool.
+class node_pool {
+public:
+    node_pool() = default;
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    ~node_pool() {
+        release();
+    }
+
+    void* allocate(std::size_t size) {
+        size_class& blocks = class_for(size);
+        if (blocks.free == nullptr) {
+            grow(blocks, blocks.next_slab_blocks);
+        }
+
+        free_block* block = blocks.free;
+        blocks.free = block->next;
+        --blocks.free_count;
+        ++in_use_;
+        return block;
+    }
+
+    void deallocate(void* pointer, std::size_t size) noexcept {
+        // The class exists: it was created by the matching allocate().
+        size_class& blocks = *find_class(block_size_for(size));
+        free_block* block = static_cast<free_block*>(pointer);
+        block->next = blocks.free;
+        blocks.free = block;
+        ++blocks.free_count;
+        --in_use_;
+    }
+
+    void reserve(std::size_t size, std::size_t count) {
+        size_class& blocks = class_for(size);
+        if (blocks.free_count < count) {
+            grow(blocks, count - blocks.free_count);
+        }
+    }
+
+    std::size_t in_use() const noexcept {
+        return in_use_;
+    }
+
+    void release() noexcept {
+        while (slabs_ != nullptr) {
+            slab_header* next = slabs_->next;
+            ::operator delete(slabs_);
+            slabs_ = next;
+        }
+        for (size_class& blocks : classes_) {
+            blocks.free = nullptr;
+            blocks.free_count = 0;
+            blocks.next_slab_blocks = initial_slab_blocks;
+        }
+        in_use_ = 0;
+    }
+
+private:
+    struct free_block {
+        free_block* next;
+    };
+
+    struct slab_header {
+        slab_header* next;
+    };
+
+    struct size_class {
+        std::size_t block_size;
+        free_block* free = nullptr;
+        std::size_t free_count = 0;
+        std::size_t next_slab_blocks = initial_slab_blocks;
+    };
+
+    static constexpr std::size_t alignment = alignof(std::max_align_t);
+    static constexpr std::size_t initial_slab_blocks = 64;
+    static constexpr std::size_t max_slab_blocks = 64 * 1024;
+
+    static std::size_t round_up(std::size_t size) noexcept {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    static std::size_t block_size_for(std::size_t size) noexcept {
+        return round_up(size > sizeof(free_block) ? size : sizeof(free_block));
+    }
+
+    // A pool usually serves one or two sizes (the node type, plus whatever a
+    // rebound copy asks for), so a linear scan beats any index.
+    size_class* find_class(std::size_t block_size) noexcept {
+        for (size_class& blocks : classes_) {
+            if (blocks.block_size == block_size) {
+                return &blocks;
+            }
+        }
+        return nullptr;
+    }
+
+    size_class& class_for(std::size_t size) {
+        const std::size_t block_size = block_size_for(size);
+        if (size_class* blocks = find_class(block_size)) {
+            return *blocks;
+        }
+        classes_.push_back(size_class{block_size});
+        return classes_.back();
+    }
+
+    void grow(size_class& blocks, std::size_t count) {
+        const std::size_t header = round_up(sizeof(slab_header));
+        if (count > (static_cast<std::size_t>(-1) - header) / blocks.block_size) {
+            throw std::bad_alloc();
+        }
+
+        char* memory = static_cast<char*>(::operator new(header + count * blocks.block_size));
+        slab_header* slab = reinterpret_cast<slab_header*>(memory);
+        slab->next = slabs_;
+        slabs_ = slab;
+
+        // Thread blocks in address order so consecutive allocations are adjacent.
+        for (std::size_t i = count; i-- > 0;) {
+            free_block* block = reinterpret_cast<free_block*>(memory + header + i * blocks.block_size);
+            block->next = blocks.free;
+            blocks.free = block;
+        }
+        blocks.free_count += count;
+        if (blocks.next_slab_blocks < max_slab_blocks) {
+            blocks.next_slab_blocks *= 2;
+        }
+    }
+
+    std::vector<size_class> classes_;
+    std::size_t in_use_ = 0;
+    slab_header* slabs_ = nullptr;
+};
+
+template <typename Alloc, typename = void>
+struct supports_reserve : std::false_type {};
+
+template <typename Alloc>
+struct supports_reserve<Alloc, std::void_t<decltype(std::declval<Alloc&>().reserve(std::size_t()))>>
+    : std::true_type {};
+
+template <typename Alloc, typename = void>
+struct supports_release : std::false_type {};
+
+template <typename Alloc>
+struct supports_release<Alloc, std::void_t<decltype(std::declval<Alloc&>().release()),
+                                           decltype(std::declval<const Alloc&>().in_use())>> : std::true_type {};
+
+} // namespace detail
+
+/**
+ * @brief Allocator that carves single nodes out of large slabs.
+ *
+ * Freed nodes go onto a free list and are reused before a new slab is
+ * requested; slabs double in size up to 64K nodes. Copies, including rebound
+ * copies, share one pool, so trees constructed from the same allocator can
+ * exchange nodes. Each object size has its own free list, so allocating a
+ * different type through a rebound copy never pushes nodes off the pool.
+ * Requests for more than one object, or for over-aligned types, go straight
+ * to `::operator new`.
+ *
+ * `BinarySearchTree` recognises this allocator: `reserve()` pre-allocates
+ * slabs, and when a tree is the only user of its pool and neither `T` nor
+ * the node metadata needs a destructor, `clear()` and the destructor return
+ * whole slabs at once instead of freeing nodes one by one.
+ *
+ * @tparam T Allocated value type.
+ *
+ * @note
+ * The pool is not thread-safe; trees sharing a pool must not be modified
+ * concurrently.
+ */
+template <typename T>
+class pool_allocator {
+public:
+    using value_type = T;
+    // Trees hand their pool along with their nodes.
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /**
+     * @brief Creates an allocator with a new, empty pool.
+     */
+    pool_allocator() : pool_(std::make_shared<detail::node_pool>()) {}
+
+    // Copies (and moves) share the pool, so the source stays usable.
+    pool_allocator(const pool_allocator&) = default;
+    pool_allocator& operator=(const pool_allocator&) = default;
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& other) noexcept : pool_(other.pool_) {}
+
+    T* allocate(std::size_t count) {
+        if (uses_pool(count)) {
+            return static_cast<T*>(pool_->allocate(sizeof(T)));
+        }
+        if (count > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* pointer, std::size_t count) noexcept {
+        if (uses_pool(count)) {
+            pool_->deallocate(pointer, sizeof(T));
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+    /**
+     * @brief Ensures the pool holds at least `count` free blocks for `T`.
+     *
+     * @param count Number of objects to pre-allocate room for.
+     *
+     * @complexity
+     * Linear in the number of blocks added.
+     */
+    void reserve(std::size_t count) {
+        if (uses_pool(1)) {
+            pool_->reserve(sizeof(T), count);
+        }
+    }
+
+    /**
+     * @brief Returns the number of pool blocks, of any size, currently handed out.
+     */
+    std::size_t in_use() const noexcept {
+        return pool_->in_use();
+    }
+
+    /**
+     * @brief Returns every slab to the heap at once.
+     *
+     * All blocks handed out by the pool become invalid, so callers must have
+     * finished with every object allocated from it (see `in_use()`).
+     */
+    void release() noexcept {
+        pool_->release();
+    }
+
+    template <typename U>
+    bool operator==(const pool_allocator<U>& other) const noexcept {
+        return pool_ == other.pool_;
+    }
+
+    template <typename U>
+    bool operator!=(const pool_allocator<U>& other) const noexcept {
+        return pool_ != other.pool_;
+    }
+
+private:
+    static bool uses_pool(std::size_t count) noexcept {
+        return count == 1 && alignof(T) <= alignof(std::max_align_t);
+    }
+
+    std::shared_ptr<detail::node_pool> pool_;
+
+    template <typename>
+    friend class pool_allocator;
+};
+
+} // namespace bst
+
 /**
  * @brief A header-only Binary Search Tree container.
  *
  * `BinarySearchTree` stores unique values in sorted order using a classic
- * binary search tree. The tree uses `std::unique_ptr` internally for
- * ownership, supports bidirectional iterators, and provides STL-style lookup
- * and insertion APIs.
+ * binary search tree. Nodes are obtained from `Allocator` (rebound to the
+ * internal node type), the tree supports bidirectional iterators, and it
+ * provides STL-style lookup and insertion APIs.
  *
- * This container is intentionally a plain Binary Search Tree. It does not
- * rebalance itself, so operation costs depend on tree shape.
+ * By default this container is a plain Binary Search Tree that does not
+ * rebalance itself, so operation costs depend on tree shape. Passing a
+ * balancing policy such as `bst::avl_balance` or `bst::red_black_balance`
+ * keeps the height logarithmic without changing the iterator or comparator
+ * API.
  *
  * @tparam T Stored value type.
  * @tparam Compare Strict weak ordering used to compare values.
+ * @tparam Balance Balancing policy: `bst::no_balance`, `bst::avl_balance`,
+ *         `bst::red_black_balance`, `bst::splay_balance`,
+ *         `bst::treap_balance`, or `bst::scapegoat_balance<>`. Wrap any
+ *         of them in `bst::threaded<>` for O(1) iterator steps.
+ * @tparam Allocator Allocator for `T`, rebound to the node type. Use
+ *         `bst::pool_allocator<T>` to carve nodes out of slabs.
  *
  * @complexity
  * Construction of an empty tree is O(1).
@@ -31,7 +670,8 @@
  * @note
  * This container does not allow duplicate values.
  */
-template <typename T, typename Compare = std::less<T>>
+template <typename T, typename Compare = std::less<T>, typename Balance = bst::no_balance,
+          typename Allocator = std::allocator<T>>
 class BinarySearchTree {
 public:
     using value_type = T;
@@ -40,25 +680,138 @@ public:
     using value_compare = Compare;
     using reference = value_type&;
     using const_reference = const value_type&;
+    using balance_policy = Balance;
+    using allocator_type = Allocator;
+    // Result of `aggregate()` with `bst::augmented`; `void` otherwise.
+    using aggregate_type =
+        typename bst::detail::aggregate_value<typename bst::detail::policy_traits<Balance>::aggregate>::type;
 
 private:
-    struct Node {
-        value_type value;
-        std::unique_ptr<Node> left;
-        std::unique_ptr<Node> right;
+    // The `bst::threaded`, `bst::order_statistics`, and `bst::augmented`
+    // wrappers around a policy `B` balance like `B`.
+    using base_balance = typename bst::detail::policy_traits<Balance>::base;
+
+    static constexpr bool is_threaded = bst::detail::policy_traits<Balance>::has_threads;
+    static constexpr bool is_avl = std::is_same<base_balance, bst::avl_balance>::value;
+    static constexpr bool is_red_black = std::is_same<base_balance, bst::red_black_balance>::value;
+    static constexpr bool is_splay = std::is_same<base_balance, bst::splay_balance>::value;
+    static constexpr bool is_treap = std::is_same<base_balance, bst::treap_balance>::value;
+    static constexpr bool is_scapegoat = bst::detail::is_scapegoat_balance<base_balance>::value;
+    // Policies whose shape is free, so arbitrary rebuilds keep them valid.
+    static constexpr bool is_reshapeable = !is_avl && !is_red_black && !is_treap;
+    static constexpr bool is_unbalanced = std::is_same<base_balance, bst::no_balance>::value;
+    // Treaps size subtrees for split(); `bst::order_statistics` adds sizes to
+    // any other policy.
+    static constexpr bool has_subtree_counts = is_treap || bst::detail::policy_traits<Balance>::has_counts;
+    using aggregate_policy = typename bst::detail::policy_traits<Balance>::aggregate;
+    static constexpr bool has_aggregate = !std::is_void<aggregate_policy>::value;
+    // Sizes and aggregates that insert and erase must refresh along the
+    // changed path; treaps already refresh their sizes while rebalancing.
+    static constexpr bool has_path_summaries = (has_subtree_counts && !is_treap) || has_aggregate;
+    static constexpr bool is_interval_tree = bst::detail::is_interval_aggregate<aggregate_policy>::value;
+
+    static_assert(std::is_same<base_balance, bst::no_balance>::value || is_avl || is_red_black || is_splay ||
+                      is_treap || is_scapegoat,
+                  "BinarySearchTree: unsupported balancing policy");
+
+    using balance_data = bst::detail::node_metadata<base_balance, bst::detail::policy_traits<Balance>::has_counts,
+                                                    aggregate_policy>;
+
+    struct Node;
+
+    // Child links own their subtrees structurally, but storage belongs to the
+    // tree's allocator, so dropping a link frees nothing: nodes are released
+    // explicitly through destroy_node() and destroy_subtree().
+    struct node_deleter {
+        void operator()(Node*) const noexcept {}
+    };
+
+    using node_ptr = std::unique_ptr<Node, node_deleter>;
+
+    struct Node : balance_data, bst::detail::thread_node_data<Node, is_threaded> {
+        // Constructed and destroyed separately by create_node() and
+        // destroy_node(), so allocator-aware values can receive the tree's
+        // allocator.
+        union {
+            value_type value;
+        };
+        node_ptr left;
+        node_ptr right;
         Node* parent;
 
-        explicit Node(const value_type& new_value, Node* new_parent = nullptr)
-            : value(new_value), left(nullptr), right(nullptr), parent(new_parent) {}
+        explicit Node(Node* new_parent) noexcept : left(nullptr), right(nullptr), parent(new_parent) {}
+
+        ~Node() {}
+    };
+
+    // Link accessors for the algorithms shared with `IntrusiveBinarySearchTree`.
+    struct node_links {
+        using node_type = Node;
+        using link_type = node_ptr;
+
+        static Node* left(const Node* node) noexcept {
+            return node->left.get();
+        }
+
+        static Node* right(const Node* node) noexcept {
+            return node->right.get();
+        }
+
+        static Node* parent(const Node* node) noexcept {
+            return node->parent;
+        }
+
+        static node_ptr& left_link(Node* node) noexcept {
+            return node->left;
+        }
+
+        static node_ptr& right_link(Node* node) noexcept {
+            return node->right;
+        }
+
+        static Node* get(const node_ptr& link) noexcept {
+            return link.get();
+        }
+
+        // The deleter is a no-op, so resetting a link only relinks.
+        static void set(node_ptr& link, Node* node) noexcept {
+            link.reset(node);
+        }
+
+        static void set_parent(Node* node, Node* parent) noexcept {
+            node->parent = parent;
+        }
+
+        static const value_type& value(const Node* node) noexcept {
+            return node->value;
+        }
 
-        explicit Node(value_type&& new_value, Node* new_parent = nullptr)
-            : value(std::move(new_value)), left(nullptr), right(nullptr), parent(new_parent) {}
+        static void update(Node* node) noexcept {
+            update_node(node);
+        }
     };
 
-    using node_ptr = std::unique_ptr<Node>;
+    using algorithms = bst::detail::tree_algorithms<node_links>;
 
+    using node_allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<node_allocator_type>;
+
+    // Temporary buffers of batch operations draw from the tree's allocator,
+    // so a pmr tree never falls back to the default resource.
+    template <typename U>
+    using scratch_vector = std::vector<U, typename std::allocator_traits<Allocator>::template rebind_alloc<U>>;
+
+    static_assert(std::is_same<typename node_traits::pointer, Node*>::value,
+                  "BinarySearchTree: allocators with fancy pointers are not supported");
+
+    node_allocator_type node_alloc_;
     node_ptr root_;
     size_type size_;
+    // Largest size since the last full rebuild; only used by scapegoat trees.
+    size_type max_size_;
+    // Insert depths above `rebuild_threshold_ * log2(size_)` trigger a partial
+    // rebuild; 0 disables the check.
+    double rebuild_threshold_;
     Compare compare_;
 
     static bool equivalent(const value_type& lhs, const value_type& rhs, const Compare& compare) {
@@ -91,7 +844,7 @@ private:
 
         tree_iterator& operator++() {
             if (tree_ != nullptr) {
-                node_ = tree_->successor(node_);
+                node_ = tree_->next_node(node_);
             }
             return *this;
         }
@@ -110,7 +863,7 @@ private:
             if (node_ == nullptr) {
                 node_ = tree_->max_node(tree_->root_.get());
             } else {
-                node_ = tree_->predecessor(node_);
+                node_ = tree_->prev_node(node_);
             }
             return *this;
         }
@@ -147,15 +900,129 @@ public:
     using const_iterator = tree_iterator<const value_type, const value_type*, const value_type&>;
 
     /**
-     * @brief Constructs an empty binary search tree.
+     * @brief Move-only owner of a node taken out of a tree by `extract()`.
+     *
+     * The handle keeps the node's allocation and value alive, so the value
+     * can be inspected or modified and the node linked into another tree of
+     * the same type without reallocating or moving the value. An empty
+     * handle owns nothing; a non-empty handle frees its node when destroyed.
+     */
+    class node_type {
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+
+        constexpr node_type() noexcept : node_(nullptr) {}
+
+        node_type(node_type&& other) noexcept
+            : node_(std::exchange(other.node_, nullptr)), alloc_(std::move(other.alloc_)) {
+            other.alloc_.reset();
+        }
+
+        node_type& operator=(node_type&& other) noexcept {
+            if (this != &other) {
+                reset();
+                node_ = std::exchange(other.node_, nullptr);
+                alloc_ = std::move(other.alloc_);
+                other.alloc_.reset();
+            }
+            return *this;
+        }
+
+        ~node_type() {
+            reset();
+        }
+
+        /**
+         * @brief Checks whether the handle owns no node.
+         */
+        bool empty() const noexcept {
+            return node_ == nullptr;
+        }
+
+        explicit operator bool() const noexcept {
+            return node_ != nullptr;
+        }
+
+        /**
+         * @brief Returns the owned value. The handle must not be empty.
+         */
+        value_type& value() const noexcept {
+            return node_->value;
+        }
+
+        /**
+         * @brief Returns the allocator of the tree the node came from. The handle must not be empty.
+         */
+        allocator_type get_allocator() const {
+            return allocator_type(*alloc_);
+        }
+
+        void swap(node_type& other) noexcept {
+            using std::swap;
+            swap(node_, other.node_);
+            swap(alloc_, other.alloc_);
+        }
+
+        friend void swap(node_type& lhs, node_type& rhs) noexcept {
+            lhs.swap(rhs);
+        }
+
+    private:
+        Node* node_;
+        std::optional<node_allocator_type> alloc_;
+
+        node_type(Node* node, const node_allocator_type& alloc) : node_(node), alloc_(alloc) {}
+
+        void reset() noexcept {
+            if (node_ != nullptr) {
+                destroy_node(*alloc_, std::exchange(node_, nullptr));
+                alloc_.reset();
+            }
+        }
+
+        friend class BinarySearchTree;
+    };
+
+    /**
+     * @brief Result of `insert(node_type&&)`.
+     *
+     * `position` points to the inserted element or to the element that
+     * blocked insertion. When insertion failed, `node` still owns the handle's
+     * node; otherwise it is empty.
+     */
+    struct insert_return_type {
+        iterator position;
+        bool inserted;
+        node_type node;
+    };
+
+    /**
+     * @brief Constructs an empty binary search tree.
      *
      * @param compare Comparison object used to order elements.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Constant.
+     */
+    explicit BinarySearchTree(const Compare& compare = Compare(), const Allocator& alloc = Allocator())
+        : node_alloc_(alloc),
+          root_(nullptr),
+          size_(0),
+          max_size_(0),
+          rebuild_threshold_(0.0),
+          compare_(compare) {}
+
+    /**
+     * @brief Constructs an empty tree that allocates nodes from `alloc`.
+     *
+     * @param alloc Allocator that provides node storage.
      *
      * @complexity
      * Constant.
      */
-    explicit BinarySearchTree(const Compare& compare = Compare())
-        : root_(nullptr), size_(0), compare_(compare) {}
+    explicit BinarySearchTree(const Allocator& alloc) : BinarySearchTree(Compare(), alloc) {}
 
     /**
      * @brief Constructs a tree from an iterator range.
@@ -166,17 +1033,59 @@ public:
      * @param first Iterator to the first element in the range.
      * @param last Iterator one past the last element in the range.
      * @param compare Comparison object used to order elements.
+     * @param alloc Allocator that provides node storage.
      *
      * @complexity
      * Average: O(N log N) for N inserted elements when the tree stays reasonably balanced.
      * Worst: O(N^2) when the tree becomes highly unbalanced.
      */
     template <typename InputIt>
-    BinarySearchTree(InputIt first, InputIt last, const Compare& compare = Compare())
-        : BinarySearchTree(compare) {
+    BinarySearchTree(InputIt first, InputIt last, const Compare& compare = Compare(),
+                     const Allocator& alloc = Allocator())
+        : BinarySearchTree(compare, alloc) {
         insert(first, last);
     }
 
+    /**
+     * @brief Constructs a tree from an iterator range using `alloc`.
+     *
+     * @tparam InputIt Input iterator type.
+     * @param first Iterator to the first element in the range.
+     * @param last Iterator one past the last element in the range.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Same as the range constructor above.
+     */
+    template <typename InputIt>
+    BinarySearchTree(InputIt first, InputIt last, const Allocator& alloc)
+        : BinarySearchTree(first, last, Compare(), alloc) {}
+
+    /**
+     * @brief Builds a balanced tree from a sorted range of unique values.
+     *
+     * Nodes are allocated in a single pass and linked directly into a
+     * complete tree (a random treap for `bst::treap_balance`) without
+     * per-element descent.
+     *
+     * @tparam RandomIt Random access iterator type.
+     * @param first Iterator to the first element in the range.
+     * @param last Iterator one past the last element in the range.
+     * @param compare Comparison object used to order elements.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Linear in `std::distance(first, last)`.
+     *
+     * @throws std::invalid_argument If the range is not strictly increasing under `compare`.
+     */
+    template <typename RandomIt>
+    BinarySearchTree(bst::sorted_unique_t, RandomIt first, RandomIt last, const Compare& compare = Compare(),
+                     const Allocator& alloc = Allocator())
+        : BinarySearchTree(compare, alloc) {
+        assign(bst::sorted_unique, first, last);
+    }
+
     /**
      * @brief Constructs a tree from an initializer list.
      *
@@ -184,28 +1093,66 @@ public:
      *
      * @param init Initial values to insert.
      * @param compare Comparison object used to order elements.
+     * @param alloc Allocator that provides node storage.
      *
      * @complexity
      * Average: O(N log N) for N inserted elements when the tree stays reasonably balanced.
      * Worst: O(N^2) when the tree becomes highly unbalanced.
      */
-    BinarySearchTree(std::initializer_list<T> init, const Compare& compare = Compare())
-        : BinarySearchTree(compare) {
+    BinarySearchTree(std::initializer_list<T> init, const Compare& compare = Compare(),
+                     const Allocator& alloc = Allocator())
+        : BinarySearchTree(compare, alloc) {
         insert(init.begin(), init.end());
     }
 
+    /**
+     * @brief Constructs a tree from an initializer list using `alloc`.
+     *
+     * @param init Initial values to insert.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Same as the initializer-list constructor above.
+     */
+    BinarySearchTree(std::initializer_list<T> init, const Allocator& alloc)
+        : BinarySearchTree(init, Compare(), alloc) {}
+
     /**
      * @brief Copy-constructs a tree from another tree.
      *
+     * The allocator is obtained through
+     * `std::allocator_traits<Allocator>::select_on_container_copy_construction`.
+     *
      * @param other Tree to copy.
      *
      * @complexity
      * Linear in `other.size()`.
      */
     BinarySearchTree(const BinarySearchTree& other)
-        : root_(clone_subtree(other.root_.get(), nullptr)),
+        : BinarySearchTree(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(
+                                      other.get_allocator())) {}
+
+    /**
+     * @brief Copy-constructs a tree whose nodes are allocated from `alloc`.
+     *
+     * The copy walks `other` without recursion, so the shape of `other` does
+     * not matter. With `bst::pool_allocator` all nodes come from one slab.
+     *
+     * @param other Tree to copy.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Linear in `other.size()` with constant extra space.
+     */
+    BinarySearchTree(const BinarySearchTree& other, const Allocator& alloc)
+        : node_alloc_(alloc),
+          root_(clone_tree(static_cast<const Node*>(other.root_.get()), other.size_)),
           size_(other.size_),
-          compare_(other.compare_) {}
+          max_size_(other.max_size_),
+          rebuild_threshold_(other.rebuild_threshold_),
+          compare_(other.compare_) {
+        rethread();
+    }
 
     /**
      * @brief Move-constructs a tree from another tree.
@@ -216,33 +1163,82 @@ public:
      * Constant.
      */
     BinarySearchTree(BinarySearchTree&& other) noexcept
-        : root_(std::move(other.root_)),
+        : node_alloc_(other.node_alloc_),
+          root_(std::move(other.root_)),
           size_(other.size_),
+          max_size_(other.max_size_),
+          rebuild_threshold_(other.rebuild_threshold_),
           compare_(std::move(other.compare_)) {
         other.size_ = 0;
+        other.max_size_ = 0;
+    }
+
+    /**
+     * @brief Move-constructs a tree whose nodes are allocated from `alloc`.
+     *
+     * When `alloc` equals `other.get_allocator()` the nodes are taken over.
+     * Otherwise each value is moved into a node allocated from `alloc` and
+     * `other` is cleared.
+     *
+     * @param other Tree to move from.
+     * @param alloc Allocator that provides node storage.
+     *
+     * @complexity
+     * Constant if the allocators are equal, otherwise linear in `other.size()`.
+     */
+    BinarySearchTree(BinarySearchTree&& other, const Allocator& alloc)
+        : node_alloc_(alloc),
+          root_(nullptr),
+          size_(other.size_),
+          max_size_(other.max_size_),
+          rebuild_threshold_(other.rebuild_threshold_),
+          compare_(other.compare_) {
+        if (node_traits::is_always_equal::value || node_alloc_ == other.node_alloc_) {
+            root_ = std::move(other.root_);
+            other.size_ = 0;
+            other.max_size_ = 0;
+        } else {
+            root_ = clone_tree(other.root_.get(), other.size_);
+            rethread();
+            other.clear();
+        }
     }
 
     /**
      * @brief Destroys the tree.
      *
+     * Releases pooled slabs wholesale under the same conditions as `clear()`.
+     *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()` with constant extra space.
      */
-    ~BinarySearchTree() = default;
+    ~BinarySearchTree() {
+        destroy_all_nodes();
+    }
 
     /**
      * @brief Copy-assigns the contents of another tree.
      *
+     * The allocator is replaced only if
+     * `propagate_on_container_copy_assignment` is true for `Allocator`.
+     *
      * @param other Tree to copy from.
      * @return BinarySearchTree& Reference to this tree.
      *
      * @complexity
-     * Linear in `other.size()`.
+     * Linear in `size()` plus `other.size()`.
      */
     BinarySearchTree& operator=(const BinarySearchTree& other) {
         if (this != &other) {
-            BinarySearchTree copy(other);
-            swap(copy);
+            if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+                BinarySearchTree copy(other, other.get_allocator());
+                clear();
+                node_alloc_ = other.node_alloc_;
+                take_nodes(copy);
+            } else {
+                BinarySearchTree copy(other, get_allocator());
+                take_nodes(copy);
+            }
         }
         return *this;
     }
@@ -250,25 +1246,95 @@ public:
     /**
      * @brief Move-assigns the contents of another tree.
      *
+     * Nodes are taken over when `propagate_on_container_move_assignment` is
+     * true for `Allocator` or the two allocators compare equal. Otherwise
+     * each value is moved into a node allocated by this tree's allocator.
+     *
      * @param other Tree to move from.
      * @return BinarySearchTree& Reference to this tree.
      *
      * @complexity
-     * Constant.
+     * Linear in `size()` when nodes are taken over, otherwise linear in
+     * `size()` plus `other.size()`.
      */
-    BinarySearchTree& operator=(BinarySearchTree&& other) noexcept {
+    BinarySearchTree& operator=(BinarySearchTree&& other) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value) {
         if (this != &other) {
-            root_ = std::move(other.root_);
-            size_ = other.size_;
-            compare_ = std::move(other.compare_);
-            other.size_ = 0;
+            if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+                clear();
+                node_alloc_ = other.node_alloc_;
+                take_nodes(other);
+            } else {
+                if (node_traits::is_always_equal::value || node_alloc_ == other.node_alloc_) {
+                    take_nodes(other);
+                } else {
+                    BinarySearchTree moved(std::move(other), get_allocator());
+                    take_nodes(moved);
+                }
+            }
         }
         return *this;
     }
 
+    /**
+     * @brief Returns a copy of the allocator used for node storage.
+     *
+     * @return allocator_type The tree's allocator, rebound back to `T`.
+     *
+     * @complexity
+     * Constant.
+     */
+    allocator_type get_allocator() const noexcept {
+        return allocator_type(node_alloc_);
+    }
+
+    /**
+     * @brief Replaces the contents with a sorted range of unique values.
+     *
+     * Builds the new tree exactly like the `bst::sorted_unique` constructor.
+     * If building fails, the tree is left unchanged.
+     *
+     * @tparam RandomIt Random access iterator type.
+     * @param first Iterator to the first element in the range.
+     * @param last Iterator one past the last element in the range.
+     *
+     * @complexity
+     * Linear in `size()` plus `std::distance(first, last)`.
+     *
+     * @throws std::invalid_argument If the range is not strictly increasing.
+     */
+    template <typename RandomIt>
+    void assign(bst::sorted_unique_t, RandomIt first, RandomIt last) {
+        static_assert(std::is_base_of<std::random_access_iterator_tag,
+                                      typename std::iterator_traits<RandomIt>::iterator_category>::value,
+                      "BinarySearchTree::assign(sorted_unique_t, ...) requires random access iterators");
+
+        for (RandomIt it = first; it != last && it + 1 != last; ++it) {
+            if (!compare_(*it, *(it + 1))) {
+                throw std::invalid_argument("BinarySearchTree: sorted_unique input is not strictly increasing");
+            }
+        }
+
+        const size_type count = static_cast<size_type>(last - first);
+        auto make_node = [this, first](size_type i) {
+            return create_node(nullptr, first[static_cast<difference_type>(i)]);
+        };
+        node_ptr built = build_from_sorted(make_node, count);
+
+        clear();
+        root_ = std::move(built);
+        size_ = count;
+        max_size_ = count;
+        rethread();
+    }
+
     /**
      * @brief Swaps the contents of two trees.
      *
+     * Allocators are swapped only if `propagate_on_container_swap` is true
+     * for `Allocator`; otherwise they must compare equal.
+     *
      * @param other Tree to swap with.
      *
      * @complexity
@@ -276,8 +1342,13 @@ public:
      */
     void swap(BinarySearchTree& other) {
         using std::swap;
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+            swap(node_alloc_, other.node_alloc_);
+        }
         swap(root_, other.root_);
         swap(size_, other.size_);
+        swap(max_size_, other.max_size_);
+        swap(rebuild_threshold_, other.rebuild_threshold_);
         swap(compare_, other.compare_);
     }
 
@@ -305,15 +1376,43 @@ public:
         return size_ == 0;
     }
 
+    /**
+     * @brief Pre-allocates node storage for a tree of `count` elements.
+     *
+     * With `bst::pool_allocator` the pool grows by one slab large enough for
+     * the missing nodes, so the following inserts do not touch the heap. With
+     * other allocators this does nothing.
+     *
+     * @param count Number of elements the tree should be able to hold.
+     *
+     * @complexity
+     * Linear in the number of nodes reserved.
+     */
+    void reserve(size_type count) {
+        if constexpr (bst::detail::supports_reserve<node_allocator_type>::value) {
+            if (count > size_) {
+                node_alloc_.reserve(count - size_);
+            }
+        }
+    }
+
     /**
      * @brief Removes all elements from the tree.
      *
+     * When the tree is the only user of its `bst::pool_allocator` and both `T`
+     * and the node metadata (for example an `augmented` summary) are
+     * trivially destructible, the pool's slabs are released at once instead
+     * of freeing each node. Teardown is iterative, so even a degenerate tree
+     * does not grow the call stack.
+     *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()` with constant extra space, or linear in the number
+     * of slabs in the pooled case above.
      */
     void clear() noexcept {
-        root_.reset();
+        destroy_all_nodes();
         size_ = 0;
+        max_size_ = 0;
     }
 
     /**
@@ -355,20 +1454,34 @@ public:
     /**
      * @brief Inserts each element in a range.
      *
-     * Duplicate values are ignored.
+     * Duplicate values are ignored; among equivalent values the element
+     * already in the tree, or else the first one in the range, is kept.
+     *
+     * The range is buffered and sorted first. Ascending runs are detected and
+     * merged, so sorted or nearly sorted input costs linear time. The sorted
+     * batch is then linked in as a balanced tree: an empty tree is built
+     * directly, a batch at least half the size of the tree is merged with the
+     * existing nodes and the result is relinked, and smaller batches are
+     * inserted median first so they never form chains.
      *
      * @tparam InputIt Input iterator type.
      * @param first Iterator to the first element to insert.
      * @param last Iterator one past the last element to insert.
      *
      * @complexity
-     * Average: O(M log(N + M)) for M inserted elements when the tree stays reasonably balanced.
-     * Worst: O(M(N + M)) when the tree is highly unbalanced.
+     * O(M log M) to sort M values, O(M) when they arrive in a few sorted runs.
+     * Linking costs O(N + M) for large batches, otherwise M descents of the tree.
      */
     template <typename InputIt>
     void insert(InputIt first, InputIt last) {
-        for (; first != last; ++first) {
-            insert(*first);
+        if constexpr (std::is_move_constructible<T>::value && std::is_move_assignable<T>::value) {
+            scratch_vector<T> batch(first, last, scratch_allocator<T>());
+            sort_batch(batch);
+            insert_sorted_batch(batch);
+        } else {
+            for (; first != last; ++first) {
+                insert(*first);
+            }
         }
     }
 
@@ -434,11 +1547,145 @@ public:
             return end();
         }
 
-        Node* next = successor(position.node_);
+        Node* next = next_node(position.node_);
         erase_node(link_from_node(position.node_));
         return iterator(next, this);
     }
 
+    /**
+     * @brief Unlinks the element at an iterator position and returns it as a node handle.
+     *
+     * The node is neither freed nor copied; the value stays where it is.
+     *
+     * @param position Iterator pointing to the element to extract.
+     * @return node_type Handle owning the extracted node, or an empty handle
+     *         for `end()`.
+     *
+     * @complexity
+     * Same as `erase(position)`.
+     *
+     * @note
+     * Only iterators to the extracted element are invalidated. Pointers and
+     * references to its value stay valid and refer to the value in the handle.
+     */
+    node_type extract(const_iterator position) {
+        if (position.tree_ != this || position.node_ == nullptr) {
+            return node_type();
+        }
+
+        Node* node = unlink_node(link_from_node(position.node_)).release();
+        return node_type(node, node_alloc_);
+    }
+
+    /**
+     * @brief Unlinks the element equal to `value` and returns it as a node handle.
+     *
+     * @param value The value to search for.
+     * @return node_type Handle owning the extracted node, or an empty handle
+     *         if no element matches.
+     *
+     * @complexity
+     * Same as `erase(value)`.
+     */
+    node_type extract(const T& value) {
+        node_ptr* link = find_link(value);
+        if (*link == nullptr) {
+            return node_type();
+        }
+
+        Node* node = unlink_node(link).release();
+        return node_type(node, node_alloc_);
+    }
+
+    /**
+     * @brief Links the node owned by a handle into the tree.
+     *
+     * The node is reused as is: nothing is allocated and the value is not
+     * moved. If an equivalent element already exists, the handle keeps its
+     * node and is returned in `node`.
+     *
+     * @param node Handle from `extract()` on a tree of the same type, or empty.
+     * @return insert_return_type Position, whether insertion happened, and
+     *         the handle if it did not.
+     *
+     * @complexity
+     * Same as `insert(value)`.
+     *
+     * @throws std::invalid_argument If the handle's allocator cannot free
+     *         nodes of this tree's allocator.
+     */
+    insert_return_type insert(node_type&& node) {
+        if (node.empty()) {
+            return {end(), false, node_type()};
+        }
+        if (!node_traits::is_always_equal::value && !(*node.alloc_ == node_alloc_)) {
+            throw std::invalid_argument("BinarySearchTree::insert() requires a node handle with an equal allocator");
+        }
+
+        auto result = link_new_node(node.value(), [&node](Node* parent) {
+            return adopt_node(std::exchange(node.node_, nullptr), parent);
+        });
+        if (result.second) {
+            node.alloc_.reset();
+            return {result.first, true, node_type()};
+        }
+        return {result.first, false, std::move(node)};
+    }
+
+    /**
+     * @brief Moves every element of `other` whose key is not present here into this tree.
+     *
+     * Nodes are relinked, never copied or reallocated, and elements with an
+     * equivalent key already in `*this` stay in `other`. A small `other` is
+     * spliced in node by node; when `other` holds at least half as many
+     * elements as `*this`, both trees are merged in one in-order pass and
+     * relinked as balanced trees instead.
+     *
+     * @param other Tree to take elements from.
+     *
+     * @complexity
+     * O(M log(N + M)) for M elements spliced one by one, otherwise O(N + M).
+     *
+     * @throws std::invalid_argument If the trees' allocators compare unequal.
+     *
+     * @note
+     * Iterators to moved elements stay valid but now refer into `*this`.
+     */
+    void merge(BinarySearchTree& other) {
+        if (this == &other || other.root_ == nullptr) {
+            return;
+        }
+        if (!node_traits::is_always_equal::value && !(node_alloc_ == other.node_alloc_)) {
+            throw std::invalid_argument("BinarySearchTree::merge() requires equal allocators");
+        }
+
+        if (other.size_ >= size_ / 2) {
+            merge_all_nodes(other);
+            return;
+        }
+
+        Node* node = min_node(other.root_.get());
+        while (node != nullptr) {
+            Node* next = other.next_node(node);
+            link_new_node(node->value, [&other, node](Node* parent) {
+                return adopt_node(other.unlink_node(other.link_from_node(node)).release(), parent);
+            });
+            node = next;
+        }
+    }
+
+    /**
+     * @brief Moves every element of `other` whose key is not present here into this tree.
+     *
+     * @param other Tree to take elements from.
+     *
+     * @complexity
+     * Same as `merge(BinarySearchTree&)`.
+     */
+    void merge(BinarySearchTree&& other) {
+        merge(other);
+    }
+
     /**
      * @brief Finds an element equal to `value`.
      *
@@ -448,9 +1695,16 @@ public:
      * @complexity
      * Average: O(log N) when the tree is reasonably balanced.
      * Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @note
+     * With `bst::splay_balance` the returned node, or the last node visited
+     * when there is none, is splayed to the root.
      */
     iterator find(const T& value) {
-        return iterator(find_node(value), this);
+        Node* last = nullptr;
+        Node* node = find_node(value, &last);
+        on_access(node != nullptr ? node : last);
+        return iterator(node, this);
     }
 
     /**
@@ -490,9 +1744,16 @@ public:
      * @complexity
      * Average: O(log N) when the tree is reasonably balanced.
      * Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @note
+     * With `bst::splay_balance` the returned node, or the last node visited
+     * when there is none, is splayed to the root.
      */
     iterator lower_bound(const T& value) {
-        return iterator(lower_bound_node(value), this);
+        Node* last = nullptr;
+        Node* node = lower_bound_node(value, &last);
+        on_access(node != nullptr ? node : last);
+        return iterator(node, this);
     }
 
     /**
@@ -538,51 +1799,363 @@ public:
     }
 
     /**
-     * @brief Returns an iterator to the smallest element.
+     * @brief Returns an iterator to the element at zero-based position `k` in
+     * sorted order.
      *
-     * @return iterator Iterator to the first element, or `end()` if the tree is empty.
+     * Requires subtree sizes: `bst::order_statistics<Policy>` or
+     * `bst::treap_balance`.
+     *
+     * @param k Position, `0` for the smallest element.
+     * @return iterator Iterator to the element, or `end()` if `k >= size()`.
      *
      * @complexity
-     * Average: O(log N).
-     * Worst: O(N).
+     * O(h), where h is the tree height: O(log N) for balanced policies.
+     *
+     * @note
+     * With `bst::splay_balance` the returned node is splayed to the root.
      */
-    iterator begin() noexcept {
-        return iterator(min_node(root_.get()), this);
+    iterator nth(size_type k) {
+        static_assert(has_subtree_counts,
+                      "BinarySearchTree::nth() requires bst::order_statistics or bst::treap_balance");
+
+        Node* node = nth_node(k);
+        on_access(node);
+        return iterator(node, this);
     }
 
     /**
-     * @brief Returns an iterator to the smallest element.
+     * @brief Returns an iterator to the element at zero-based position `k` in
+     * sorted order.
      *
-     * @return const_iterator Iterator to the first element, or `cend()` if the tree is empty.
+     * Requires subtree sizes: `bst::order_statistics<Policy>` or
+     * `bst::treap_balance`.
+     *
+     * @param k Position, `0` for the smallest element.
+     * @return const_iterator Iterator to the element, or `cend()` if `k >= size()`.
      *
      * @complexity
-     * Average: O(log N).
-     * Worst: O(N).
+     * O(h), where h is the tree height: O(log N) for balanced policies.
      */
-    const_iterator begin() const noexcept {
-        return const_iterator(min_node(root_.get()), this);
+    const_iterator nth(size_type k) const {
+        static_assert(has_subtree_counts,
+                      "BinarySearchTree::nth() requires bst::order_statistics or bst::treap_balance");
+
+        return const_iterator(nth_node(k), this);
     }
 
     /**
-     * @brief Returns a const iterator to the smallest element.
+     * @brief Returns the number of elements less than `value`.
      *
-     * @return const_iterator Iterator to the first element, or `cend()` if the tree is empty.
+     * This is the position `value` has, or would have, in sorted order, so
+     * `nth(rank(value))` is `lower_bound(value)`. Requires subtree sizes:
+     * `bst::order_statistics<Policy>` or `bst::treap_balance`.
+     *
+     * @param value Lookup value; it need not be in the tree.
+     * @return size_type Count of elements ordered before `value`.
      *
      * @complexity
-     * Average: O(log N).
-     * Worst: O(N).
+     * O(h), where h is the tree height: O(log N) for balanced policies.
      */
-    const_iterator cbegin() const noexcept {
-        return begin();
+    size_type rank(const T& value) const {
+        static_assert(has_subtree_counts,
+                      "BinarySearchTree::rank() requires bst::order_statistics or bst::treap_balance");
+
+        size_type before = 0;
+        for (const Node* node = root_.get(); node != nullptr;) {
+            if (compare_(node->value, value)) {
+                before += subtree_count(node->left.get()) + 1;
+                node = node->right.get();
+            } else {
+                node = node->left.get();
+            }
+        }
+        return before;
     }
 
     /**
-     * @brief Returns an iterator representing one past the last element.
+     * @brief Returns the number of elements in `[lo, hi)`.
      *
-     * @return iterator End iterator.
+     * With subtree sizes (`bst::order_statistics<Policy>` or
+     * `bst::treap_balance`) this is `rank(hi) - rank(lo)`: two descents,
+     * whatever the width of the range. Other policies count the elements
+     * with `for_each_in_range()`.
+     *
+     * @param lo Inclusive lower bound.
+     * @param hi Exclusive upper bound.
+     * @return size_type Number of elements not less than `lo` and less than
+     * `hi`; `0` when `hi` is not greater than `lo`.
      *
      * @complexity
-     * Constant.
+     * O(h) with subtree sizes, where h is the tree height: O(log N) for
+     * balanced policies. Otherwise O(h + K) for K counted elements.
+     */
+    size_type count_in_range(const T& lo, const T& hi) const {
+        if (!compare_(lo, hi)) {
+            return 0;
+        }
+
+        if constexpr (has_subtree_counts) {
+            return rank(hi) - rank(lo);
+        } else {
+            size_type count = 0;
+            for_each_in_range(lo, hi, [&count](const T&) { ++count; });
+            return count;
+        }
+    }
+
+    /**
+     * @brief Returns the aggregate of every element.
+     *
+     * Requires `bst::augmented<Aggregate, Policy>`.
+     *
+     * @return aggregate_type The cached aggregate of the root, or
+     * `Aggregate::identity()` for an empty tree.
+     *
+     * @complexity
+     * Constant.
+     */
+    aggregate_type aggregate() const {
+        static_assert(has_aggregate, "BinarySearchTree::aggregate() requires bst::augmented");
+
+        return root_ != nullptr ? root_->summary : aggregate_policy::identity();
+    }
+
+    /**
+     * @brief Returns the aggregate of the elements in `[lo, hi)`.
+     *
+     * Combines the cached aggregates of the subtrees that lie inside the range
+     * along the two boundary paths, in sorted order, so the elements between
+     * the boundaries are never visited. Requires
+     * `bst::augmented<Aggregate, Policy>`.
+     *
+     * @param lo Inclusive lower bound.
+     * @param hi Exclusive upper bound.
+     * @return aggregate_type Combined value of the elements in range, or
+     * `Aggregate::identity()` when there are none.
+     *
+     * @complexity
+     * O(h), where h is the tree height: O(log N) for balanced policies.
+     */
+    aggregate_type aggregate(const T& lo, const T& hi) const {
+        static_assert(has_aggregate, "BinarySearchTree::aggregate() requires bst::augmented");
+
+        // The highest node in range splits it into a suffix of its left
+        // subtree, itself, and a prefix of its right subtree.
+        const Node* split = root_.get();
+        while (split != nullptr) {
+            if (compare_(split->value, lo)) {
+                split = split->right.get();
+            } else if (!compare_(split->value, hi)) {
+                split = split->left.get();
+            } else {
+                break;
+            }
+        }
+        if (split == nullptr) {
+            return aggregate_policy::identity();
+        }
+
+        aggregate_type result = aggregate_policy::project(split->value);
+        for (const Node* node = split->left.get(); node != nullptr;) {
+            if (compare_(node->value, lo)) {
+                node = node->right.get();
+                continue;
+            }
+            if (node->right != nullptr) {
+                result = aggregate_policy::combine(node->right->summary, result);
+            }
+            result = aggregate_policy::combine(aggregate_policy::project(node->value), result);
+            node = node->left.get();
+        }
+        for (const Node* node = split->right.get(); node != nullptr;) {
+            if (!compare_(node->value, hi)) {
+                node = node->left.get();
+                continue;
+            }
+            if (node->left != nullptr) {
+                result = aggregate_policy::combine(result, node->left->summary);
+            }
+            result = aggregate_policy::combine(result, aggregate_policy::project(node->value));
+            node = node->right.get();
+        }
+        return result;
+    }
+
+    /**
+     * @brief Visits, in sorted order, the intervals that contain `point`.
+     *
+     * Requires `bst::max_upper_endpoint` as the aggregate, as in
+     * `bst::IntervalTree`. An interval `[lower, upper)` contains `point`
+     * when `lower <= point < upper`.
+     *
+     * @tparam Endpoint Type comparable with the interval endpoints.
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param point Query point.
+     * @param function Callable invoked for each matching interval; returning
+     * `bst::visit::stop` ends the search.
+     *
+     * @complexity
+     * O(min(N, (K + 1) * h)) for K matches, where h is the tree height:
+     * O(log N) per match for balanced policies.
+     */
+    template <typename Endpoint, typename UnaryFunction>
+    void for_each_overlapping(const Endpoint& point, UnaryFunction&& function) const {
+        static_assert(is_interval_tree, "BinarySearchTree::for_each_overlapping() requires bst::max_upper_endpoint");
+
+        auto visitor = std::forward<UnaryFunction>(function);
+        visit_containing(point, [&visitor](const Node* node) {
+            return bst::detail::keep_visiting(visitor, node->value);
+        });
+    }
+
+    /**
+     * @brief Visits, in sorted order, the intervals that overlap `[lo, hi)`.
+     *
+     * Requires `bst::max_upper_endpoint` as the aggregate, as in
+     * `bst::IntervalTree`. An interval `[lower, upper)` overlaps the query
+     * when `lower < hi` and `lo < upper`; nothing overlaps an empty query.
+     *
+     * @tparam Endpoint Type comparable with the interval endpoints.
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param lo Inclusive start of the query.
+     * @param hi Exclusive end of the query.
+     * @param function Callable invoked for each overlapping interval;
+     * returning `bst::visit::stop` ends the search.
+     *
+     * @complexity
+     * O(min(N, (K + 1) * h)) for K matches, where h is the tree height:
+     * O(log N) per match for balanced policies.
+     */
+    template <typename Endpoint, typename UnaryFunction>
+    void for_each_overlapping(const Endpoint& lo, const Endpoint& hi, UnaryFunction&& function) const {
+        static_assert(is_interval_tree, "BinarySearchTree::for_each_overlapping() requires bst::max_upper_endpoint");
+
+        auto visitor = std::forward<UnaryFunction>(function);
+        visit_overlapping(lo, hi, [&visitor](const Node* node) {
+            return bst::detail::keep_visiting(visitor, node->value);
+        });
+    }
+
+    /**
+     * @brief Returns iterators to the intervals that contain `point`.
+     *
+     * See `for_each_overlapping(point, function)`. The iterators can be
+     * passed to `erase()` or `extract()`.
+     *
+     * @param point Query point.
+     * @return std::vector<const_iterator> Matches in sorted order.
+     *
+     * @complexity
+     * O(min(N, (K + 1) * h)) for K matches, where h is the tree height.
+     */
+    template <typename Endpoint>
+    std::vector<const_iterator> overlapping(const Endpoint& point) const {
+        static_assert(is_interval_tree, "BinarySearchTree::overlapping() requires bst::max_upper_endpoint");
+
+        std::vector<const_iterator> matches;
+        visit_containing(point, [this, &matches](Node* node) {
+            matches.push_back(const_iterator(node, this));
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns iterators to the intervals that overlap `[lo, hi)`.
+     *
+     * See `for_each_overlapping(lo, hi, function)`. The iterators can be
+     * passed to `erase()` or `extract()`.
+     *
+     * @param lo Inclusive start of the query.
+     * @param hi Exclusive end of the query.
+     * @return std::vector<const_iterator> Matches in sorted order.
+     *
+     * @complexity
+     * O(min(N, (K + 1) * h)) for K matches, where h is the tree height.
+     */
+    template <typename Endpoint>
+    std::vector<const_iterator> overlapping(const Endpoint& lo, const Endpoint& hi) const {
+        static_assert(is_interval_tree, "BinarySearchTree::overlapping() requires bst::max_upper_endpoint");
+
+        std::vector<const_iterator> matches;
+        visit_overlapping(lo, hi, [this, &matches](Node* node) {
+            matches.push_back(const_iterator(node, this));
+            return true;
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns the number of increments from `first` to `last`.
+     *
+     * Equivalent to `std::distance(first, last)` without stepping through the
+     * elements. Requires subtree sizes: `bst::order_statistics<Policy>` or
+     * `bst::treap_balance`.
+     *
+     * @param first Iterator into this tree, or `end()`.
+     * @param last Iterator into this tree, or `end()`.
+     * @return difference_type Position of `last` minus position of `first`;
+     * negative when `last` comes before `first`.
+     *
+     * @complexity
+     * O(h), where h is the tree height: O(log N) for balanced policies.
+     */
+    difference_type distance(const_iterator first, const_iterator last) const {
+        static_assert(has_subtree_counts,
+                      "BinarySearchTree::distance() requires bst::order_statistics or bst::treap_balance");
+
+        return static_cast<difference_type>(position_of(last.node_)) -
+               static_cast<difference_type>(position_of(first.node_));
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     *
+     * @return iterator Iterator to the first element, or `end()` if the tree is empty.
+     *
+     * @complexity
+     * Average: O(log N).
+     * Worst: O(N).
+     */
+    iterator begin() noexcept {
+        return iterator(min_node(root_.get()), this);
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     *
+     * @return const_iterator Iterator to the first element, or `cend()` if the tree is empty.
+     *
+     * @complexity
+     * Average: O(log N).
+     * Worst: O(N).
+     */
+    const_iterator begin() const noexcept {
+        return const_iterator(min_node(root_.get()), this);
+    }
+
+    /**
+     * @brief Returns a const iterator to the smallest element.
+     *
+     * @return const_iterator Iterator to the first element, or `cend()` if the tree is empty.
+     *
+     * @complexity
+     * Average: O(log N).
+     * Worst: O(N).
+     */
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    /**
+     * @brief Returns an iterator representing one past the last element.
+     *
+     * @return iterator End iterator.
+     *
+     * @complexity
+     * Constant.
      */
     iterator end() noexcept {
         return iterator(nullptr, this);
@@ -697,10 +2270,23 @@ public:
      * @return size_type Tree height.
      *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()`, bounded extra space.
      */
     size_type height() const noexcept {
-        return height_of(root_.get());
+        size_type height = 0;
+        size_type depth = 0;
+        walk(
+            [&depth, &height](const Node&) {
+                ++depth;
+                height = depth > height ? depth : height;
+                return true;
+            },
+            [](const Node&) { return true; },
+            [&depth](const Node&) {
+                --depth;
+                return true;
+            });
+        return height;
     }
 
     /**
@@ -725,16 +2311,24 @@ public:
      *
      * In-order traversal visits nodes in sorted order.
      *
-     * @tparam UnaryFunction Callable type accepting `const T&`.
-     * @param function Callable invoked for each visited element.
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param function Callable invoked for each visited element; returning
+     * `bst::visit::stop` ends the traversal.
      *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()`, or up to the element that stopped the traversal;
+     * bounded extra space; nothing recurses.
      */
     template <typename UnaryFunction>
     void in_order_traversal(UnaryFunction&& function) const {
         auto visitor = std::forward<UnaryFunction>(function);
-        in_order_impl(root_.get(), visitor);
+        walk(
+            [](const Node&) { return true; },
+            [&visitor](const Node& node) {
+                return bst::detail::keep_visiting(visitor, node.value);
+            },
+            [](const Node&) { return true; });
     }
 
     /**
@@ -742,16 +2336,23 @@ public:
      *
      * Pre-order traversal visits nodes in Root-Left-Right order.
      *
-     * @tparam UnaryFunction Callable type accepting `const T&`.
-     * @param function Callable invoked for each visited element.
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param function Callable invoked for each visited element; returning
+     * `bst::visit::stop` ends the traversal.
      *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()`, or up to the element that stopped the traversal;
+     * bounded extra space; nothing recurses.
      */
     template <typename UnaryFunction>
     void pre_order_traversal(UnaryFunction&& function) const {
         auto visitor = std::forward<UnaryFunction>(function);
-        pre_order_impl(root_.get(), visitor);
+        walk(
+            [&visitor](const Node& node) {
+                return bst::detail::keep_visiting(visitor, node.value);
+            },
+            [](const Node&) { return true; }, [](const Node&) { return true; });
     }
 
     /**
@@ -759,82 +2360,364 @@ public:
      *
      * Post-order traversal visits nodes in Left-Right-Root order.
      *
-     * @tparam UnaryFunction Callable type accepting `const T&`.
-     * @param function Callable invoked for each visited element.
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param function Callable invoked for each visited element; returning
+     * `bst::visit::stop` ends the traversal.
      *
      * @complexity
-     * Linear in `size()`.
+     * Linear in `size()`, or up to the element that stopped the traversal;
+     * bounded extra space; nothing recurses.
      */
     template <typename UnaryFunction>
     void post_order_traversal(UnaryFunction&& function) const {
         auto visitor = std::forward<UnaryFunction>(function);
-        post_order_impl(root_.get(), visitor);
+        walk(
+            [](const Node&) { return true; }, [](const Node&) { return true; },
+            [&visitor](const Node& node) {
+                return bst::detail::keep_visiting(visitor, node.value);
+            });
+    }
+
+    /**
+     * @brief Visits the elements in `[lo, hi)` in sorted order.
+     *
+     * Only the path down to `lo` and the visited elements are touched;
+     * subtrees that lie entirely below `lo` or at or above `hi` are skipped.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`, returning
+     * `void` or `bst::visit`.
+     * @param lo Inclusive lower bound.
+     * @param hi Exclusive upper bound.
+     * @param function Callable invoked for each element in the range;
+     * returning `bst::visit::stop` ends the scan.
+     *
+     * @complexity
+     * Average: O(log N + K) for K visited elements when the tree is
+     * reasonably balanced.
+     * Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @note
+     * Nothing is visited when `hi` is not greater than `lo`. The scan does not
+     * splay, even with `bst::splay_balance`.
+     */
+    template <typename UnaryFunction>
+    void for_each_in_range(const T& lo, const T& hi, UnaryFunction&& function) const {
+        auto visitor = std::forward<UnaryFunction>(function);
+        if constexpr (is_threaded) {
+            for (const Node* node = lower_bound_node(lo); node != nullptr && compare_(node->value, hi);
+                 node = node->next) {
+                if (!bst::detail::keep_visiting(visitor, node->value)) {
+                    return;
+                }
+            }
+        } else {
+            // Nodes still owed a visit, nearest last. Only nodes not below
+            // `lo` are pushed, so the left subtrees of skipped nodes are never
+            // entered. When the deepest ones have been dropped, the next node
+            // is found by climbing from the last one visited instead.
+            constexpr size_type capacity = 64;
+            Node* pending[capacity];
+            size_type top = 0;
+            size_type kept = 0;
+            const auto push_lower_spine = [&](Node* node) {
+                while (node != nullptr) {
+                    if (compare_(node->value, lo)) {
+                        node = node->right.get();
+                    } else {
+                        pending[top++ % capacity] = node;
+                        kept += kept < capacity ? 1 : 0;
+                        node = node->left.get();
+                    }
+                }
+            };
+
+            push_lower_spine(root_.get());
+            Node* last = nullptr;
+            while (true) {
+                Node* current;
+                if (kept != 0) {
+                    current = pending[--top % capacity];
+                    --kept;
+                } else if (last != nullptr) {
+                    current = successor(last);
+                } else {
+                    current = nullptr;
+                }
+                if (current == nullptr || !compare_(current->value, hi) ||
+                    !bst::detail::keep_visiting(visitor, current->value)) {
+                    return;
+                }
+                last = current;
+                push_lower_spine(current->right.get());
+            }
+        }
     }
 
     /**
      * @brief Verifies that the tree still satisfies Binary Search Tree ordering.
      *
+     * Also checks that every child's parent link points back to its parent.
+     *
      * @return bool `true` if the tree is valid, otherwise `false`.
      *
      * @complexity
      * Linear in `size()`.
      */
     bool is_valid_bst() const {
-        return is_valid_subtree(root_.get(), nullptr, nullptr);
+        return is_valid_tree();
     }
 
-private:
-    template <typename Value>
-    std::pair<iterator, bool> insert_impl(Value&& value) {
-        node_ptr* current = &root_;
-        Node* parent = nullptr;
+    /**
+     * @brief Reshapes the tree into a complete binary tree in place.
+     *
+     * Uses the Day-Stout-Warren algorithm: existing nodes are relinked, so
+     * nothing is allocated and iterators stay valid. Afterwards `height()` is
+     * `ceil(log2(size() + 1))`. Useful after bulk-loading in sorted order.
+     *
+     * Available for policies without per-node metadata: `bst::no_balance`,
+     * `bst::splay_balance`, and `bst::scapegoat_balance`.
+     *
+     * @complexity
+     * Linear in `size()` with constant extra space.
+     */
+    void rebalance() noexcept {
+        static_assert(is_reshapeable,
+                      "BinarySearchTree::rebalance() is not available for policies with per-node metadata");
 
-        while (*current != nullptr) {
-            parent = current->get();
-            if (compare_(value, parent->value)) {
-                current = &parent->left;
-            } else if (compare_(parent->value, value)) {
-                current = &parent->right;
-            } else {
-                return std::make_pair(iterator(parent, this), false);
-            }
+        rebuild_subtree(&root_, size_);
+        max_size_ = size_;
+    }
+
+    /**
+     * @brief Makes the tree rebuild itself when an insertion lands too deep.
+     *
+     * When an insertion lands more than `factor * log2(size())` edges below
+     * the root, the tree climbs from the new leaf to the lowest ancestor whose
+     * subtree fits under that limit once rebuilt, and rebuilds only that
+     * subtree in place. The depth is counted during the normal insert descent,
+     * so the check itself is free, and rebuilding small subtrees instead of
+     * the whole tree avoids latency spikes.
+     *
+     * Enabling the threshold rebuilds the whole tree if it is already taller
+     * than `factor * log2(size()) + 1`. From then on `height()` stays within
+     * that bound after every insertion, so monitoring code no longer needs to
+     * walk the tree. Erasure never rebuilds: it can only lower depths, but it
+     * shrinks `size()`, so after erasures the height is bounded by the largest
+     * size reached instead. Call `rebalance()` to restore the tighter bound.
+     *
+     * Available with `bst::no_balance`, optionally wrapped in `threaded`,
+     * `order_statistics`, or `augmented`. Splay trees move accessed nodes to
+     * the root and may leave others arbitrarily deep, so no bound can hold
+     * for them.
+     *
+     * @param factor Height factor `c`, greater than `1`, or `0` to disable.
+     *
+     * @complexity
+     * Linear in `size()` when enabling on a non-empty tree, otherwise constant.
+     *
+     * @throws std::invalid_argument If `factor` is neither `0` nor greater than `1`.
+     */
+    void set_rebuild_threshold(double factor) {
+        static_assert(is_unbalanced, "BinarySearchTree::set_rebuild_threshold() requires bst::no_balance");
+
+        if (factor != 0.0 && !(factor > 1.0)) {
+            throw std::invalid_argument("BinarySearchTree::set_rebuild_threshold() factor must be 0 or greater than 1");
         }
+        rebuild_threshold_ = factor;
+        if (factor > 0.0 && size_ > 1 && static_cast<double>(height()) > rebuild_depth_limit() + 1.0) {
+            rebalance();
+        }
+    }
 
-        *current = std::make_unique<Node>(std::forward<Value>(value), parent);
-        ++size_;
-        return std::make_pair(iterator(current->get(), this), true);
+    /**
+     * @brief Returns the height factor set by `set_rebuild_threshold()`.
+     *
+     * @return double The current factor, or `0` when automatic rebuilds are off.
+     *
+     * @complexity
+     * Constant.
+     */
+    double rebuild_threshold() const noexcept {
+        return rebuild_threshold_;
     }
 
-    Node* find_node(const T& value) const {
-        Node* current = root_.get();
+    /**
+     * @brief Moves every element not less than `value` into a new tree.
+     *
+     * Only available with `bst::treap_balance`. Existing nodes are relinked;
+     * no element is copied or reallocated, and iterators to moved elements
+     * now belong to the returned tree.
+     *
+     * @param value Split key.
+     * @return BinarySearchTree Tree holding the elements not less than `value`.
+     *
+     * @complexity
+     * Expected O(log N).
+     */
+    BinarySearchTree split(const T& value) {
+        static_assert(is_treap, "BinarySearchTree::split() requires bst::treap_balance");
+
+        BinarySearchTree upper(compare_, get_allocator());
+        node_ptr current = std::move(root_);
+        node_ptr* lower_hole = &root_;
+        node_ptr* upper_hole = &upper.root_;
+        Node* lower_parent = nullptr;
+        Node* upper_parent = nullptr;
 
         while (current != nullptr) {
-            if (compare_(value, current->value)) {
-                current = current->left.get();
-            } else if (compare_(current->value, value)) {
-                current = current->right.get();
+            if (compare_(current->value, value)) {
+                node_ptr next = std::move(current->right);
+                current->parent = lower_parent;
+                lower_parent = current.get();
+                *lower_hole = std::move(current);
+                lower_hole = &lower_parent->right;
+                current = std::move(next);
             } else {
-                return current;
+                node_ptr next = std::move(current->left);
+                current->parent = upper_parent;
+                upper_parent = current.get();
+                *upper_hole = std::move(current);
+                upper_hole = &upper_parent->left;
+                current = std::move(next);
             }
         }
 
-        return nullptr;
+        update_path(lower_parent);
+        update_path(upper_parent);
+        if constexpr (is_threaded) {
+            // The split point is the only place where the thread list breaks.
+            if (Node* last = max_node(root_.get())) {
+                last->next = nullptr;
+            }
+            if (Node* first = min_node(upper.root_.get())) {
+                first->prev = nullptr;
+            }
+        }
+        upper.size_ = subtree_count(upper.root_.get());
+        size_ -= upper.size_;
+        return upper;
     }
 
-    node_ptr* find_link(const T& value) {
-        node_ptr* current = &root_;
+    /**
+     * @brief Appends every element of `other`, which must all be greater than
+     * the elements of this tree.
+     *
+     * Only available with `bst::treap_balance`. Nodes are relinked without
+     * copying or reallocation and `other` is left empty.
+     *
+     * @param other Tree whose elements all order after this tree's elements.
+     *
+     * @complexity
+     * Expected O(log N + log M).
+     *
+     * @throws std::invalid_argument If the key ranges of the two trees overlap.
+     */
+    void join(BinarySearchTree&& other) {
+        static_assert(is_treap, "BinarySearchTree::join() requires bst::treap_balance");
+
+        if (this == &other || other.root_ == nullptr) {
+            return;
+        }
+        if (root_ != nullptr &&
+            !compare_(max_node(root_.get())->value, min_node(other.root_.get())->value)) {
+            throw std::invalid_argument("BinarySearchTree::join() requires disjoint, ordered key ranges");
+        }
+        if (!node_traits::is_always_equal::value && !(node_alloc_ == other.node_alloc_)) {
+            throw std::invalid_argument("BinarySearchTree::join() requires equal allocators");
+        }
+        if constexpr (is_threaded) {
+            if (root_ != nullptr) {
+                Node* last = max_node(root_.get());
+                Node* first = min_node(other.root_.get());
+                last->next = first;
+                first->prev = last;
+            }
+        }
+
+        node_ptr lower = std::move(root_);
+        node_ptr upper = std::move(other.root_);
+        node_ptr* hole = &root_;
+        Node* parent = nullptr;
 
-        while (*current != nullptr) {
-            if (compare_(value, (*current)->value)) {
-                current = &(*current)->left;
-            } else if (compare_((*current)->value, value)) {
-                current = &(*current)->right;
+        while (lower != nullptr && upper != nullptr) {
+            if (lower->priority > upper->priority) {
+                node_ptr next = std::move(lower->right);
+                lower->parent = parent;
+                parent = lower.get();
+                *hole = std::move(lower);
+                hole = &parent->right;
+                lower = std::move(next);
             } else {
-                return current;
+                node_ptr next = std::move(upper->left);
+                upper->parent = parent;
+                parent = upper.get();
+                *hole = std::move(upper);
+                hole = &parent->left;
+                upper = std::move(next);
             }
         }
 
-        return current;
+        *hole = lower != nullptr ? std::move(lower) : std::move(upper);
+        if (*hole != nullptr) {
+            (*hole)->parent = parent;
+        }
+        update_path(parent);
+
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+private:
+    template <typename Value>
+    std::pair<iterator, bool> insert_impl(Value&& value) {
+        return link_new_node(value, [this, &value](Node* parent) {
+            return create_node(parent, std::forward<Value>(value));
+        });
+    }
+
+    // Prepares a node taken from a tree of this type for relinking as a leaf.
+    static node_ptr adopt_node(Node* node, Node* parent) noexcept {
+        static_cast<balance_data&>(*node) = balance_data();
+        node->parent = parent;
+        return node_ptr(node);
+    }
+
+    // Descends to where `key` belongs and, unless an equivalent element is
+    // already there, links the node returned by `make_node(parent)` as a leaf.
+    template <typename MakeNode>
+    std::pair<iterator, bool> link_new_node(const T& key, MakeNode&& make_node) {
+        Node* parent;
+        size_type depth;
+        node_ptr* current = algorithms::insert_position(root_, key, compare_, parent, &depth);
+
+        if (*current != nullptr) {
+            Node* existing = current->get();
+            on_access(existing);
+            return std::make_pair(iterator(existing, this), false);
+        }
+
+        *current = make_node(parent);
+        Node* inserted = current->get();
+        thread_leaf(inserted);
+        ++size_;
+        if constexpr (has_path_summaries) {
+            // Account for the leaf before rebalancing: rotations recompute
+            // summaries from their children, so those must already be right.
+            update_summary_path(inserted);
+        }
+        rebalance_after_insert(inserted, depth);
+        return std::make_pair(iterator(inserted, this), true);
+    }
+
+    // `last_visited`, when given, receives the node where the search ended.
+    Node* find_node(const T& value, Node** last_visited = nullptr) const {
+        return algorithms::find(root_.get(), value, compare_, last_visited);
+    }
+
+    node_ptr* find_link(const T& value) {
+        Node* parent;
+        return algorithms::insert_position(root_, value, compare_, parent);
     }
 
     node_ptr* link_from_node(Node* node) {
@@ -850,219 +2733,1172 @@ private:
     }
 
     void erase_node(node_ptr* target_link) {
-        node_ptr removed = std::move(*target_link);
-        Node* parent = removed->parent;
-
-        if (removed->left == nullptr) {
-            *target_link = std::move(removed->right);
-            if (*target_link != nullptr) {
-                (*target_link)->parent = parent;
-            }
-        } else if (removed->right == nullptr) {
-            *target_link = std::move(removed->left);
-            if (*target_link != nullptr) {
-                (*target_link)->parent = parent;
-            }
-        } else if (removed->right->left == nullptr) {
-            node_ptr successor = std::move(removed->right);
-            successor->left = std::move(removed->left);
-            successor->left->parent = successor.get();
-            successor->parent = parent;
-            *target_link = std::move(successor);
-        } else {
-            node_ptr* successor_link = &removed->right;
-            while ((*successor_link)->left != nullptr) {
-                successor_link = &(*successor_link)->left;
-            }
-
-            node_ptr successor = std::move(*successor_link);
-            Node* successor_parent = successor->parent;
-
-            *successor_link = std::move(successor->right);
-            if (*successor_link != nullptr) {
-                (*successor_link)->parent = successor_parent;
-            }
+        destroy_node(unlink_node(target_link).release());
+    }
 
-            successor->left = std::move(removed->left);
-            successor->left->parent = successor.get();
-            successor->right = std::move(removed->right);
-            successor->right->parent = successor.get();
-            successor->parent = parent;
-            *target_link = std::move(successor);
+    // Detaches the node owned by `target_link` from the tree, rebalances, and
+    // returns it with null children and a stale parent.
+    node_ptr unlink_node(node_ptr* target_link) {
+        target_link = prepare_erase(target_link);
+        Node* removed = target_link->get();
+        const bool two_children = removed->left != nullptr && removed->right != nullptr;
+        // The position that physically lost a node: `fix_parent` is the lowest
+        // node whose children changed and `fix_child` took the vacated slot.
+        Node* fix_parent = nullptr;
+        Node* fix_child = nullptr;
+
+        Node* replacement = algorithms::unlink(removed, root_, fix_parent, fix_child);
+        if (two_children) {
+            swap_balance_data(*replacement, *removed);
         }
 
         --size_;
+        if constexpr (has_path_summaries) {
+            update_summary_path(fix_parent);
+        }
+        rebalance_after_erase(fix_parent, fix_child, *removed);
+        unthread(removed);
+        return node_ptr(removed);
     }
 
-    Node* lower_bound_node(const T& value) const {
-        Node* current = root_.get();
-        Node* candidate = nullptr;
+    // The successor spliced into an erased node's position inherits that
+    // position's balance metadata so ancestors still see the old shape, while
+    // `removed` keeps the metadata of the slot that was actually vacated.
+    static void swap_balance_data(balance_data& successor, balance_data& removed) noexcept {
+        using std::swap;
+        swap(successor, removed);
+    }
 
-        while (current != nullptr) {
-            if (!compare_(current->value, value)) {
-                candidate = current;
-                current = current->left.get();
-            } else {
-                current = current->right.get();
+    // Gives the balancing policy a chance to restructure before the node owned
+    // by `link` is unlinked. Returns the node's link afterwards.
+    node_ptr* prepare_erase(node_ptr* link) noexcept {
+        if constexpr (is_treap) {
+            // Rotate the doomed node down until it has at most one child.
+            Node* node = link->get();
+            while (node->left != nullptr && node->right != nullptr) {
+                Node* raised = node->left->priority > node->right->priority ? rotate_right(link)
+                                                                            : rotate_left(link);
+                link = raised->left.get() == node ? &raised->left : &raised->right;
             }
         }
+        return link;
+    }
 
-        return candidate;
+    static std::size_t subtree_count(const Node* node) noexcept {
+        if constexpr (has_subtree_counts) {
+            return node == nullptr ? 0 : node->count;
+        } else {
+            return 0;
+        }
     }
 
-    Node* upper_bound_node(const T& value) const {
-        Node* current = root_.get();
-        Node* candidate = nullptr;
+    // Recomputes cached metadata from `node` up to the root.
+    static void update_path(Node* node) noexcept {
+        for (; node != nullptr; node = node->parent) {
+            update_node(node);
+        }
+    }
 
-        while (current != nullptr) {
-            if (compare_(value, current->value)) {
-                candidate = current;
-                current = current->left.get();
-            } else {
-                current = current->right.get();
-            }
+    static int node_height(const Node* node) noexcept {
+        if constexpr (is_avl) {
+            return node == nullptr ? 0 : node->height;
+        } else {
+            return 0;
         }
+    }
 
-        return candidate;
+    // Recomputes the cached metadata of `node` from its children.
+    static void update_node(Node* node) noexcept {
+        if constexpr (is_avl) {
+            const int left_height = node_height(node->left.get());
+            const int right_height = node_height(node->right.get());
+            node->height = static_cast<unsigned char>(
+                1 + (left_height > right_height ? left_height : right_height));
+        }
+        update_summaries(node);
     }
 
-    static Node* min_node(Node* node) noexcept {
-        while (node != nullptr && node->left != nullptr) {
-            node = node->left.get();
+    // Recomputes the subtree size and aggregate of `node` from its children.
+    static void update_summaries(Node* node) noexcept {
+        if constexpr (has_subtree_counts) {
+            node->count = 1 + subtree_count(node->left.get()) + subtree_count(node->right.get());
         }
-        return node;
+        if constexpr (has_aggregate) {
+            node->summary = aggregate_policy::project(node->value);
+            if (node->left != nullptr) {
+                node->summary = aggregate_policy::combine(node->left->summary, node->summary);
+            }
+            if (node->right != nullptr) {
+                node->summary = aggregate_policy::combine(node->summary, node->right->summary);
+            }
+        }
+        (void)node;
     }
 
-    static const Node* min_node(const Node* node) noexcept {
-        while (node != nullptr && node->left != nullptr) {
-            node = node->left.get();
+    static void update_summary_path(Node* node) noexcept {
+        for (; node != nullptr; node = node->parent) {
+            update_summaries(node);
         }
-        return node;
     }
 
-    static Node* max_node(Node* node) noexcept {
-        while (node != nullptr && node->right != nullptr) {
-            node = node->right.get();
+    // Rotates the subtree owned by `link` and returns its new root. Both
+    // nodes that moved get their metadata refreshed through update_node().
+    Node* rotate_left(node_ptr* link) noexcept {
+        return algorithms::rotate_left(*link);
+    }
+
+    Node* rotate_right(node_ptr* link) noexcept {
+        return algorithms::rotate_right(*link);
+    }
+
+    // Restores the AVL invariant at `link`, assuming both subtrees are valid
+    // AVL trees whose heights differ by at most two.
+    Node* avl_fix(node_ptr* link) noexcept {
+        Node* node = link->get();
+        const int balance = node_height(node->left.get()) - node_height(node->right.get());
+
+        if (balance > 1) {
+            Node* left = node->left.get();
+            if (node_height(left->left.get()) < node_height(left->right.get())) {
+                rotate_left(&node->left);
+            }
+            return rotate_right(link);
         }
+
+        if (balance < -1) {
+            Node* right = node->right.get();
+            if (node_height(right->right.get()) < node_height(right->left.get())) {
+                rotate_right(&node->right);
+            }
+            return rotate_left(link);
+        }
+
         return node;
     }
 
-    static const Node* max_node(const Node* node) noexcept {
-        while (node != nullptr && node->right != nullptr) {
-            node = node->right.get();
+    static bool is_red(const Node* node) noexcept {
+        if constexpr (is_red_black) {
+            return node != nullptr && node->red;
+        } else {
+            return false;
         }
-        return node;
     }
 
-    Node* successor(Node* node) const noexcept {
-        if (node == nullptr) {
-            return nullptr;
+    // Restores the balancing policy's invariants after `inserted` was linked
+    // in as a new leaf `depth` edges below the root.
+    void rebalance_after_insert(Node* inserted, size_type depth) noexcept {
+        if constexpr (is_unbalanced) {
+            if (rebuild_threshold_ > 0.0 && static_cast<double>(depth) > rebuild_depth_limit()) {
+                rebuild_tall_ancestor(inserted, depth);
+            }
         }
 
-        if (node->right != nullptr) {
-            return min_node(node->right.get());
+        if constexpr (is_avl) {
+            avl_rebalance_from(inserted->parent);
+        } else if constexpr (is_red_black) {
+            red_black_insert_fixup(inserted);
+        } else if constexpr (is_splay) {
+            splay(inserted);
+        } else if constexpr (is_treap) {
+            update_path(inserted->parent);
+            while (inserted->parent != nullptr && inserted->parent->priority < inserted->priority) {
+                rotate_up(inserted);
+            }
+        } else if constexpr (is_scapegoat) {
+            if (size_ > max_size_) {
+                max_size_ = size_;
+            }
+            if (depth > scapegoat_depth_limit(size_)) {
+                rebuild_scapegoat(inserted);
+            }
+        } else {
+            (void)inserted;
         }
+    }
 
-        Node* parent = node->parent;
-        while (parent != nullptr && parent->right.get() == node) {
+    // Records a lookup that ended at `node`, which may be null.
+    void on_access(Node* node) noexcept {
+        if constexpr (is_splay) {
+            if (node != nullptr) {
+                splay(node);
+            }
+        } else {
+            (void)node;
+        }
+    }
+
+    // Restores the balancing policy's invariants after erase_node vacated the
+    // slot below `parent` now held by `child`. `spliced` is the metadata the
+    // vacated slot carried before the erase.
+    void rebalance_after_erase(Node* parent, Node* child, const balance_data& spliced) noexcept {
+        if constexpr (is_avl) {
+            (void)child;
+            (void)spliced;
+            avl_rebalance_from(parent);
+        } else if constexpr (is_red_black) {
+            if (!spliced.red) {
+                red_black_erase_fixup(parent, child);
+            }
+        } else if constexpr (is_splay) {
+            (void)child;
+            (void)spliced;
+            if (parent != nullptr) {
+                splay(parent);
+            }
+        } else if constexpr (is_treap) {
+            (void)child;
+            (void)spliced;
+            update_path(parent);
+        } else if constexpr (is_scapegoat) {
+            (void)parent;
+            (void)child;
+            (void)spliced;
+            using alpha = typename base_balance::alpha;
+            if (size_ * static_cast<size_type>(alpha::den) < max_size_ * static_cast<size_type>(alpha::num)) {
+                rebuild_subtree(&root_, size_);
+                max_size_ = size_;
+            }
+        } else {
+            (void)parent;
+            (void)child;
+            (void)spliced;
+        }
+    }
+
+    // Walks from `node` towards the root updating heights and rotating until a
+    // subtree's height is unchanged.
+    void avl_rebalance_from(Node* node) noexcept {
+        while (node != nullptr) {
+            Node* parent = node->parent;
+            const int old_height = node->height;
+
+            update_node(node);
+            Node* subtree = avl_fix(link_from_node(node));
+            if (subtree->height == old_height) {
+                break;
+            }
             node = parent;
-            parent = parent->parent;
         }
-        return parent;
     }
 
-    Node* predecessor(Node* node) const noexcept {
-        if (node == nullptr) {
-            return nullptr;
+    // Deepest depth an alpha-weight-balanced tree of `count` nodes may have:
+    // floor(log_{1/alpha}(count)).
+    static size_type scapegoat_depth_limit(size_type count) noexcept {
+        using alpha = typename base_balance::alpha;
+        static const double log_inverse_alpha =
+            std::log(static_cast<double>(alpha::den) / static_cast<double>(alpha::num));
+        return static_cast<size_type>(std::log(static_cast<double>(count)) / log_inverse_alpha);
+    }
+
+    double rebuild_depth_limit() const noexcept {
+        return rebuild_threshold_ * std::log2(static_cast<double>(size_));
+    }
+
+    static size_type floor_log2(size_type count) noexcept {
+        size_type result = 0;
+        while (count > 1) {
+            count >>= 1;
+            ++result;
+        }
+        return result;
+    }
+
+    // Climbs from a leaf inserted `depth` edges below the root to the lowest
+    // ancestor whose subtree, once rebuilt into a complete tree, fits under the
+    // depth limit again, and rebuilds it. The root always qualifies.
+    void rebuild_tall_ancestor(Node* inserted, size_type depth) noexcept {
+        const double limit = rebuild_depth_limit();
+        Node* child = inserted;
+        size_type child_size = 1;
+
+        for (Node* node = inserted->parent; node != nullptr; node = node->parent) {
+            const Node* sibling = node->left.get() == child ? node->right.get() : node->left.get();
+            const size_type node_size = 1 + child_size + count_nodes(sibling);
+            --depth;
+            if (static_cast<double>(depth + floor_log2(node_size)) <= limit) {
+                rebuild_subtree(link_from_node(node), node_size);
+                return;
+            }
+            child = node;
+            child_size = node_size;
         }
+    }
 
-        if (node->left != nullptr) {
-            return max_node(node->left.get());
+    // Climbs from a too-deep leaf to the lowest ancestor whose child subtree
+    // holds more than alpha of its nodes, and rebuilds that ancestor.
+    void rebuild_scapegoat(Node* inserted) noexcept {
+        using alpha = typename base_balance::alpha;
+        Node* child = inserted;
+        size_type child_size = 1;
+
+        for (Node* node = inserted->parent; node != nullptr; node = node->parent) {
+            const Node* sibling = node->left.get() == child ? node->right.get() : node->left.get();
+            const size_type node_size = 1 + child_size + count_nodes(sibling);
+            if (child_size * static_cast<size_type>(alpha::den) >
+                node_size * static_cast<size_type>(alpha::num)) {
+                rebuild_subtree(link_from_node(node), node_size);
+                return;
+            }
+            child = node;
+            child_size = node_size;
         }
+    }
 
-        Node* parent = node->parent;
-        while (parent != nullptr && parent->left.get() == node) {
-            node = parent;
-            parent = parent->parent;
+    // Counts the nodes of a subtree by walking it through parent pointers.
+    static size_type count_nodes(const Node* root) noexcept {
+        if constexpr (has_subtree_counts) {
+            return subtree_count(root);
         }
-        return parent;
+
+        size_type count = 0;
+        const Node* node = min_node(root);
+
+        while (node != nullptr) {
+            ++count;
+            if (node->right != nullptr) {
+                node = min_node(node->right.get());
+                continue;
+            }
+            while (node != root && node->parent->right.get() == node) {
+                node = node->parent;
+            }
+            node = node == root ? nullptr : node->parent;
+        }
+
+        return count;
     }
 
-    static node_ptr clone_subtree(const Node* other, Node* parent) {
-        if (other == nullptr) {
+    // Height of a complete binary tree with `count` nodes: ceil(log2(count + 1)).
+    static size_type complete_height(size_type count) noexcept {
+        return count == 0 ? 0 : floor_log2(count) + 1;
+    }
+
+    // Links `count` sorted elements into a balanced tree. `make_node(i)`
+    // returns the node for the i-th element, either freshly allocated or an
+    // existing node whose child links were released.
+    template <typename MakeNode>
+    node_ptr build_from_sorted(MakeNode& make_node, size_type count) {
+        if constexpr (is_treap) {
+            return build_treap_sorted(make_node, count);
+        } else {
+            return build_sorted(make_node, 0, count, nullptr, 0, complete_height(count));
+        }
+    }
+
+    // Builds a complete subtree from elements [offset, offset + count);
+    // `depth` is the depth of its root and `height` that of the whole tree.
+    template <typename MakeNode>
+    node_ptr build_sorted(MakeNode& make_node, size_type offset, size_type count, Node* parent,
+                          size_type depth, size_type height) {
+        if (count == 0) {
             return nullptr;
         }
 
-        node_ptr copy = std::make_unique<Node>(other->value, parent);
-        copy->left = clone_subtree(other->left.get(), copy.get());
-        copy->right = clone_subtree(other->right.get(), copy.get());
-        return copy;
+        const size_type middle = count / 2;
+        node_ptr node = make_node(offset + middle);
+        node->parent = parent;
+        try {
+            node->left = build_sorted(make_node, offset, middle, node.get(), depth + 1, height);
+            node->right = build_sorted(make_node, offset + middle + 1, count - middle - 1, node.get(), depth + 1,
+                                       height);
+        } catch (...) {
+            destroy_subtree(node.release());
+            throw;
+        }
+        update_node(node.get());
+        if constexpr (is_red_black) {
+            // Only the bottom level of a non-perfect complete tree is red.
+            node->red = depth != 0 && depth + 1 == height;
+        }
+        return node;
     }
 
-    static size_type height_of(const Node* node) noexcept {
-        if (node == nullptr) {
-            return 0;
+    // Builds a treap from sorted elements in one left-to-right pass: each
+    // node hangs off the right spine below the last node with a higher
+    // priority and adopts the part of the spine it displaced.
+    template <typename MakeNode>
+    node_ptr build_treap_sorted(MakeNode& make_node, size_type count) {
+        node_ptr root;
+        Node* rightmost = nullptr;
+
+        for (size_type i = 0; i < count; ++i) {
+            node_ptr node;
+            try {
+                node = make_node(i);
+            } catch (...) {
+                destroy_subtree(root.release());
+                throw;
+            }
+            Node* parent = rightmost;
+            while (parent != nullptr && parent->priority < node->priority) {
+                // Leaving the spine: this subtree is final, so size it now.
+                update_node(parent);
+                parent = parent->parent;
+            }
+
+            node_ptr* link = parent == nullptr ? &root : &parent->right;
+            node->left = std::move(*link);
+            if (node->left != nullptr) {
+                node->left->parent = node.get();
+            }
+            node->parent = parent;
+            rightmost = node.get();
+            *link = std::move(node);
         }
 
-        const size_type left_height = height_of(node->left.get());
-        const size_type right_height = height_of(node->right.get());
-        return 1 + (left_height > right_height ? left_height : right_height);
+        // Subtree sizes along the right spine (everything else is final).
+        for (Node* node = rightmost; node != nullptr; node = node->parent) {
+            update_node(node);
+        }
+        return root;
     }
 
-    template <typename UnaryFunction>
-    static void in_order_impl(const Node* node, UnaryFunction& function) {
-        if (node == nullptr) {
+    template <typename U>
+    typename scratch_vector<U>::allocator_type scratch_allocator() const {
+        return typename scratch_vector<U>::allocator_type(node_alloc_);
+    }
+
+    // Sorts a buffered batch with `compare_`, keeping the first of equivalent
+    // values, and drops the duplicates. Ascending runs are detected and
+    // merged pairwise through a second buffer (a natural merge sort), so
+    // sorted input costs one pass and nothing is taken from global `new`.
+    void sort_batch(scratch_vector<T>& batch) const {
+        const auto less = [this](const T& lhs, const T& rhs) { return compare_(lhs, rhs); };
+
+        scratch_vector<size_type> run_starts(scratch_allocator<size_type>());
+        run_starts.push_back(0);
+        for (size_type i = 1; i < batch.size(); ++i) {
+            if (compare_(batch[i], batch[i - 1])) {
+                run_starts.push_back(i);
+            }
+        }
+
+        if (run_starts.size() > 1) {
+            scratch_vector<T> merged(scratch_allocator<T>());
+            scratch_vector<size_type> merged_starts(scratch_allocator<size_type>());
+            merged.reserve(batch.size());
+            while (run_starts.size() > 1) {
+                merged.clear();
+                merged_starts.clear();
+                for (size_type i = 0; i < run_starts.size(); i += 2) {
+                    merged_starts.push_back(run_starts[i]);
+                    const auto run = [&batch](size_type index) {
+                        return std::make_move_iterator(batch.begin() + static_cast<difference_type>(index));
+                    };
+                    const size_type middle = i + 1 < run_starts.size() ? run_starts[i + 1] : batch.size();
+                    const size_type end = i + 2 < run_starts.size() ? run_starts[i + 2] : batch.size();
+                    std::merge(run(run_starts[i]), run(middle), run(middle), run(end), std::back_inserter(merged),
+                               less);
+                }
+                batch.swap(merged);
+                run_starts.swap(merged_starts);
+            }
+        }
+
+        batch.erase(std::unique(batch.begin(), batch.end(),
+                                [this](const T& lhs, const T& rhs) { return !compare_(lhs, rhs); }),
+                    batch.end());
+    }
+
+    // Inserts a sorted, duplicate-free batch into the tree.
+    void insert_sorted_batch(scratch_vector<T>& batch) {
+        if (batch.empty()) {
             return;
         }
 
-        in_order_impl(node->left.get(), function);
-        function(node->value);
-        in_order_impl(node->right.get(), function);
+        if (root_ == nullptr) {
+            auto make_node = [this, &batch](size_type i) { return create_node(nullptr, std::move(batch[i])); };
+            root_ = build_from_sorted(make_node, batch.size());
+            size_ = batch.size();
+            max_size_ = size_;
+            rethread();
+        } else if (batch.size() >= size_ / 2) {
+            merge_sorted_batch(batch);
+        } else {
+            insert_median_first(batch, 0, batch.size());
+        }
     }
 
-    template <typename UnaryFunction>
-    static void pre_order_impl(const Node* node, UnaryFunction& function) {
-        if (node == nullptr) {
+    // Inserts batch[first, last) median first, so each gap between existing
+    // keys receives a balanced subtree rather than a chain.
+    void insert_median_first(scratch_vector<T>& batch, size_type first, size_type last) {
+        if (first == last) {
             return;
         }
 
-        function(node->value);
-        pre_order_impl(node->left.get(), function);
-        pre_order_impl(node->right.get(), function);
+        const size_type middle = first + (last - first) / 2;
+        insert_impl(std::move(batch[middle]));
+        insert_median_first(batch, first, middle);
+        insert_median_first(batch, middle + 1, last);
     }
 
-    template <typename UnaryFunction>
-    static void post_order_impl(const Node* node, UnaryFunction& function) {
+    // Merges a sorted batch with the existing nodes in one in-order pass and
+    // relinks everything into a balanced tree. Existing nodes are reused and
+    // win over equivalent batch values. New nodes are allocated before the
+    // tree is touched, so an allocation failure leaves it unchanged.
+    void merge_sorted_batch(scratch_vector<T>& batch) {
+        scratch_vector<node_ptr> fresh(scratch_allocator<node_ptr>());
+        scratch_vector<Node*> nodes(scratch_allocator<Node*>());
+        fresh.reserve(batch.size());
+        nodes.reserve(size_ + batch.size());
+
+        Node* existing = min_node(root_.get());
+        try {
+            for (T& value : batch) {
+                while (existing != nullptr && compare_(existing->value, value)) {
+                    existing = successor(existing);
+                }
+                if (existing == nullptr || compare_(value, existing->value)) {
+                    fresh.push_back(create_node(nullptr, std::move(value)));
+                }
+            }
+        } catch (...) {
+            for (node_ptr& node : fresh) {
+                destroy_node(node.release());
+            }
+            throw;
+        }
+
+        existing = min_node(root_.get());
+        for (node_ptr& node : fresh) {
+            while (existing != nullptr && compare_(existing->value, node->value)) {
+                nodes.push_back(existing);
+                existing = successor(existing);
+            }
+            nodes.push_back(node.release());
+        }
+        for (; existing != nullptr; existing = successor(existing)) {
+            nodes.push_back(existing);
+        }
+
+        root_.release();
+        for (Node* node : nodes) {
+            node->left.release();
+            node->right.release();
+        }
+
+        auto make_node = [&nodes](size_type i) { return node_ptr(nodes[i]); };
+        root_ = build_from_sorted(make_node, nodes.size());
+        size_ = nodes.size();
+        max_size_ = size_;
+        rethread();
+    }
+
+    // Merges the nodes of both trees in one in-order pass and relinks each
+    // tree as a balanced tree; `other` keeps the nodes whose keys collide.
+    // Only the two node lists are allocated, before either tree is touched.
+    void merge_all_nodes(BinarySearchTree& other) {
+        scratch_vector<Node*> merged(scratch_allocator<Node*>());
+        scratch_vector<Node*> kept(scratch_allocator<Node*>());
+        merged.reserve(size_ + other.size_);
+
+        Node* mine = min_node(root_.get());
+        Node* theirs = min_node(other.root_.get());
+        while (theirs != nullptr) {
+            if (mine != nullptr && compare_(mine->value, theirs->value)) {
+                merged.push_back(mine);
+                mine = successor(mine);
+            } else if (mine != nullptr && !compare_(theirs->value, mine->value)) {
+                kept.push_back(theirs);
+                theirs = other.successor(theirs);
+            } else {
+                merged.push_back(theirs);
+                theirs = other.successor(theirs);
+            }
+        }
+        for (; mine != nullptr; mine = successor(mine)) {
+            merged.push_back(mine);
+        }
+
+        root_.release();
+        other.root_.release();
+        for (Node* node : merged) {
+            node->left.release();
+            node->right.release();
+        }
+        for (Node* node : kept) {
+            node->left.release();
+            node->right.release();
+        }
+
+        auto make_merged = [&merged](size_type i) { return node_ptr(merged[i]); };
+        root_ = build_from_sorted(make_merged, merged.size());
+        size_ = merged.size();
+        max_size_ = size_;
+        rethread();
+
+        auto make_kept = [&kept](size_type i) { return node_ptr(kept[i]); };
+        other.root_ = other.build_from_sorted(make_kept, kept.size());
+        other.size_ = kept.size();
+        other.max_size_ = other.size_;
+        other.rethread();
+    }
+
+    // Relinks the `count` nodes owned by `link` into a complete binary tree
+    // with Day-Stout-Warren. Nodes keep their addresses, so iterators stay
+    // valid.
+    void rebuild_subtree(node_ptr* link, size_type count) noexcept {
+        algorithms::rebuild(*link, count);
+    }
+
+    // Rotates `node` one level up, above its parent.
+    void rotate_up(Node* node) noexcept {
+        Node* parent = node->parent;
+        if (parent->left.get() == node) {
+            rotate_right(link_from_node(parent));
+        } else {
+            rotate_left(link_from_node(parent));
+        }
+    }
+
+    // Moves `node` to the root with zig, zig-zig and zig-zag steps.
+    void splay(Node* node) noexcept {
+        while (node->parent != nullptr) {
+            Node* parent = node->parent;
+            Node* grandparent = parent->parent;
+
+            if (grandparent == nullptr) {
+                rotate_up(node);
+            } else if ((grandparent->left.get() == parent) == (parent->left.get() == node)) {
+                rotate_up(parent);
+                rotate_up(node);
+            } else {
+                rotate_up(node);
+                rotate_up(node);
+            }
+        }
+    }
+
+    // Classic red-black insert fixup: recolours up the tree and finishes with
+    // at most two rotations.
+    void red_black_insert_fixup(Node* node) noexcept {
+        while (is_red(node->parent)) {
+            Node* parent = node->parent;
+            Node* grandparent = parent->parent;
+
+            if (parent == grandparent->left.get()) {
+                Node* uncle = grandparent->right.get();
+                if (is_red(uncle)) {
+                    parent->red = false;
+                    uncle->red = false;
+                    grandparent->red = true;
+                    node = grandparent;
+                    continue;
+                }
+
+                if (node == parent->right.get()) {
+                    rotate_left(&grandparent->left);
+                    parent = node;
+                }
+                parent->red = false;
+                grandparent->red = true;
+                rotate_right(link_from_node(grandparent));
+            } else {
+                Node* uncle = grandparent->left.get();
+                if (is_red(uncle)) {
+                    parent->red = false;
+                    uncle->red = false;
+                    grandparent->red = true;
+                    node = grandparent;
+                    continue;
+                }
+
+                if (node == parent->left.get()) {
+                    rotate_right(&grandparent->right);
+                    parent = node;
+                }
+                parent->red = false;
+                grandparent->red = true;
+                rotate_left(link_from_node(grandparent));
+            }
+            break;
+        }
+
+        root_->red = false;
+    }
+
+    // Classic red-black erase fixup for a black node removed from below
+    // `parent`. `node` carries the extra black and may be null. Performs at
+    // most three rotations.
+    void red_black_erase_fixup(Node* parent, Node* node) noexcept {
+        while (node != root_.get() && !is_red(node)) {
+            if (node == parent->left.get()) {
+                Node* sibling = parent->right.get();
+                if (is_red(sibling)) {
+                    sibling->red = false;
+                    parent->red = true;
+                    rotate_left(link_from_node(parent));
+                    sibling = parent->right.get();
+                }
+
+                if (!is_red(sibling->left.get()) && !is_red(sibling->right.get())) {
+                    sibling->red = true;
+                    node = parent;
+                    parent = parent->parent;
+                    continue;
+                }
+
+                if (!is_red(sibling->right.get())) {
+                    sibling->left->red = false;
+                    sibling->red = true;
+                    sibling = rotate_right(&parent->right);
+                }
+                sibling->red = parent->red;
+                parent->red = false;
+                sibling->right->red = false;
+                rotate_left(link_from_node(parent));
+            } else {
+                Node* sibling = parent->left.get();
+                if (is_red(sibling)) {
+                    sibling->red = false;
+                    parent->red = true;
+                    rotate_right(link_from_node(parent));
+                    sibling = parent->left.get();
+                }
+
+                if (!is_red(sibling->left.get()) && !is_red(sibling->right.get())) {
+                    sibling->red = true;
+                    node = parent;
+                    parent = parent->parent;
+                    continue;
+                }
+
+                if (!is_red(sibling->left.get())) {
+                    sibling->right->red = false;
+                    sibling->red = true;
+                    sibling = rotate_left(&parent->left);
+                }
+                sibling->red = parent->red;
+                parent->red = false;
+                sibling->left->red = false;
+                rotate_right(link_from_node(parent));
+            }
+            node = root_.get();
+        }
+
+        if (node != nullptr) {
+            node->red = false;
+        }
+    }
+
+    Node* lower_bound_node(const T& value, Node** last_visited = nullptr) const {
+        return algorithms::lower_bound(root_.get(), value, compare_, last_visited);
+    }
+
+    // Descends by subtree sizes to the node with `k` nodes before it.
+    Node* nth_node(size_type k) const noexcept {
+        Node* node = root_.get();
+        while (node != nullptr) {
+            const size_type left = subtree_count(node->left.get());
+            if (k < left) {
+                node = node->left.get();
+            } else if (k == left) {
+                return node;
+            } else {
+                k -= left + 1;
+                node = node->right.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // Number of nodes before `node` in order; `size_` for the end position.
+    size_type position_of(const Node* node) const noexcept {
         if (node == nullptr) {
-            return;
+            return size_;
+        }
+
+        size_type position = subtree_count(node->left.get());
+        for (const Node* parent = node->parent; parent != nullptr; node = parent, parent = parent->parent) {
+            if (parent->right.get() == node) {
+                position += subtree_count(parent->left.get()) + 1;
+            }
+        }
+        return position;
+    }
+
+    // Intervals holding `point`: they start at or before it and end after it.
+    template <typename Endpoint, typename Visit>
+    void visit_containing(const Endpoint& point, Visit&& visit) const {
+        using traits = typename aggregate_policy::traits;
+        walk_intervals(
+            point, [&point](const T& interval) { return !(point < traits::lower(interval)); },
+            std::forward<Visit>(visit));
+    }
+
+    // Intervals overlapping `[lo, hi)`: they start before `hi` and end after `lo`.
+    template <typename Endpoint, typename Visit>
+    void visit_overlapping(const Endpoint& lo, const Endpoint& hi, Visit&& visit) const {
+        using traits = typename aggregate_policy::traits;
+        if (lo < hi) {
+            walk_intervals(
+                lo, [&hi](const T& interval) { return traits::lower(interval) < hi; },
+                std::forward<Visit>(visit));
+        }
+    }
+
+    // In-order walk over the non-empty intervals that end after `after` and
+    // satisfy `starts_in`. Subtrees whose largest upper endpoint is not after
+    // `after` are skipped, and the walk ends at the first interval starting
+    // too late, since every later one starts no earlier. `visit` returns
+    // `false` to stop. Pending ancestors use a fixed-size stack like walk();
+    // once it has dropped the deepest ones, the next ancestor is found by
+    // climbing from the last node taken, whose right subtree is finished.
+    template <typename Endpoint, typename StartsIn, typename Visit>
+    void walk_intervals(const Endpoint& after, StartsIn starts_in, Visit visit) const {
+        using traits = typename aggregate_policy::traits;
+        constexpr size_type capacity = 64;
+        Node* pending[capacity];
+        size_type top = 0;
+        size_type kept = 0;
+        const auto push_live_spine = [&](Node* node) {
+            while (node != nullptr && after < node->summary) {
+                pending[top++ % capacity] = node;
+                kept += kept < capacity ? 1 : 0;
+                node = node->left.get();
+            }
+        };
+
+        push_live_spine(root_.get());
+        Node* last = nullptr;
+        while (true) {
+            Node* current;
+            if (kept != 0) {
+                current = pending[--top % capacity];
+                --kept;
+            } else if (last != nullptr) {
+                while (last->parent != nullptr && last->parent->right.get() == last) {
+                    last = last->parent;
+                }
+                current = last->parent;
+            } else {
+                current = nullptr;
+            }
+            if (current == nullptr || !starts_in(current->value)) {
+                return;
+            }
+            const T& interval = current->value;
+            if (after < traits::upper(interval) && traits::lower(interval) < traits::upper(interval) &&
+                !visit(current)) {
+                return;
+            }
+            last = current;
+            push_live_spine(current->right.get());
+        }
+    }
+
+    Node* upper_bound_node(const T& value) const {
+        return algorithms::upper_bound(root_.get(), value, compare_);
+    }
+
+    static Node* min_node(Node* node) noexcept {
+        return algorithms::min_node(node);
+    }
+
+    static const Node* min_node(const Node* node) noexcept {
+        return algorithms::min_node(node);
+    }
+
+    static Node* max_node(Node* node) noexcept {
+        return algorithms::max_node(node);
+    }
+
+    static const Node* max_node(const Node* node) noexcept {
+        return algorithms::max_node(node);
+    }
+
+    // In-order neighbours for iteration: one load through the threads of a
+    // `bst::threaded` tree, otherwise a structural walk.
+    Node* next_node(Node* node) const noexcept {
+        if constexpr (is_threaded) {
+            return node == nullptr ? nullptr : node->next;
+        } else {
+            return successor(node);
+        }
+    }
+
+    Node* prev_node(Node* node) const noexcept {
+        if constexpr (is_threaded) {
+            return node == nullptr ? nullptr : node->prev;
+        } else {
+            return predecessor(node);
+        }
+    }
+
+    // Splices a freshly linked leaf into the thread list; its neighbours are
+    // its parent and the parent's neighbour on the same side.
+    void thread_leaf(Node* leaf) noexcept {
+        if constexpr (is_threaded) {
+            Node* parent = leaf->parent;
+            if (parent == nullptr) {
+                return;
+            }
+
+            if (parent->left.get() == leaf) {
+                leaf->next = parent;
+                leaf->prev = parent->prev;
+            } else {
+                leaf->prev = parent;
+                leaf->next = parent->next;
+            }
+            if (leaf->prev != nullptr) {
+                leaf->prev->next = leaf;
+            }
+            if (leaf->next != nullptr) {
+                leaf->next->prev = leaf;
+            }
+        } else {
+            (void)leaf;
         }
+    }
 
-        post_order_impl(node->left.get(), function);
-        post_order_impl(node->right.get(), function);
-        function(node->value);
+    void unthread(Node* node) noexcept {
+        if constexpr (is_threaded) {
+            if (node->prev != nullptr) {
+                node->prev->next = node->next;
+            }
+            if (node->next != nullptr) {
+                node->next->prev = node->prev;
+            }
+            node->prev = nullptr;
+            node->next = nullptr;
+        } else {
+            (void)node;
+        }
+    }
+
+    // Rebuilds every thread after the tree was linked in bulk.
+    void rethread() noexcept {
+        if constexpr (is_threaded) {
+            Node* previous = nullptr;
+            for (Node* node = min_node(root_.get()); node != nullptr; node = successor(node)) {
+                node->prev = previous;
+                node->next = nullptr;
+                if (previous != nullptr) {
+                    previous->next = node;
+                }
+                previous = node;
+            }
+        }
+    }
+
+    Node* successor(Node* node) const noexcept {
+        return algorithms::successor(node);
     }
 
-    bool is_valid_subtree(const Node* node, const T* lower, const T* upper) const {
+    Node* predecessor(Node* node) const noexcept {
+        return algorithms::predecessor(node);
+    }
+
+    // Copies the tree rooted at `other`, which holds `count` nodes, including
+    // balance metadata. Values are moved instead of copied when `other` is
+    // non-const. Both trees are walked in pre-order through their parent
+    // links, so the copy needs no recursion and O(1) extra space. A pooled
+    // allocator reserves every node up front, in one slab.
+    template <typename SourceNode>
+    node_ptr clone_tree(SourceNode* other, size_type count) {
+        if (other == nullptr) {
+            return nullptr;
+        }
+        if constexpr (bst::detail::supports_reserve<node_allocator_type>::value) {
+            node_alloc_.reserve(count);
+        }
+
+        node_ptr root = clone_node(other, nullptr);
+        SourceNode* source = other;
+        Node* copy = root.get();
+        try {
+            while (true) {
+                if (source->left != nullptr && copy->left == nullptr) {
+                    source = source->left.get();
+                    copy->left = clone_node(source, copy);
+                    copy = copy->left.get();
+                } else if (source->right != nullptr && copy->right == nullptr) {
+                    source = source->right.get();
+                    copy->right = clone_node(source, copy);
+                    copy = copy->right.get();
+                } else if (source != other) {
+                    source = source->parent;
+                    copy = copy->parent;
+                } else {
+                    break;
+                }
+            }
+        } catch (...) {
+            destroy_subtree(root.release());
+            throw;
+        }
+        return root;
+    }
+
+    template <typename SourceNode>
+    node_ptr clone_node(SourceNode* other, Node* parent) {
+        using source_value = std::conditional_t<std::is_const<SourceNode>::value, const T&, T&&>;
+        node_ptr copy = create_node(parent, static_cast<source_value>(other->value));
+        static_cast<balance_data&>(*copy) = static_cast<const balance_data&>(*other);
+        return copy;
+    }
+
+    // Allocates a node and constructs its value from `args`. Allocator-aware
+    // values go through `Allocator`'s construct(), so a
+    // `std::pmr::polymorphic_allocator` hands its memory resource down.
+    template <typename... Args>
+    node_ptr create_node(Node* parent, Args&&... args) {
+        Node* node = node_traits::allocate(node_alloc_, 1);
+        node_traits::construct(node_alloc_, node, parent);
+        try {
+            if constexpr (std::uses_allocator<T, Allocator>::value) {
+                Allocator value_alloc(node_alloc_);
+                std::allocator_traits<Allocator>::construct(value_alloc, std::addressof(node->value),
+                                                            std::forward<Args>(args)...);
+            } else {
+                ::new (static_cast<void*>(std::addressof(node->value))) value_type(std::forward<Args>(args)...);
+            }
+        } catch (...) {
+            node_traits::destroy(node_alloc_, node);
+            node_traits::deallocate(node_alloc_, node, 1);
+            throw;
+        }
+        return node_ptr(node);
+    }
+
+    void destroy_node(Node* node) noexcept {
+        destroy_node(node_alloc_, node);
+    }
+
+    static void destroy_node(node_allocator_type& alloc, Node* node) noexcept {
+        node->value.~value_type();
+        node_traits::destroy(alloc, node);
+        node_traits::deallocate(alloc, node, 1);
+    }
+
+    // Frees a subtree without recursion. The `parent` links are not needed
+    // while tearing down, so they are reused to chain the pending nodes into
+    // a stack: O(N) time, O(1) extra space, even for a degenerate tree.
+    void destroy_subtree(Node* node) noexcept {
         if (node == nullptr) {
-            return true;
+            return;
         }
 
-        if (lower != nullptr && !compare_(*lower, node->value)) {
-            return false;
+        node->parent = nullptr;
+        while (node != nullptr) {
+            Node* pending = node->parent;
+            if (Node* left = node->left.release()) {
+                left->parent = pending;
+                pending = left;
+            }
+            if (Node* right = node->right.release()) {
+                right->parent = pending;
+                pending = right;
+            }
+            destroy_node(node);
+            node = pending;
+        }
+    }
+
+    // Replaces this tree's contents with the nodes of `source`, whose
+    // allocator must be able to free them through `node_alloc_`.
+    void take_nodes(BinarySearchTree& source) noexcept {
+        destroy_all_nodes();
+        root_ = std::move(source.root_);
+        size_ = source.size_;
+        max_size_ = source.max_size_;
+        rebuild_threshold_ = source.rebuild_threshold_;
+        compare_ = std::move(source.compare_);
+        source.size_ = 0;
+        source.max_size_ = 0;
+    }
+
+    // Frees every node. When this tree is the only user of a pooled
+    // allocator and neither values nor node metadata (such as an `augmented`
+    // summary) need a destructor, whole slabs are dropped.
+    void destroy_all_nodes() noexcept {
+        Node* root = root_.release();
+        if constexpr (std::is_trivially_destructible<T>::value &&
+                      std::is_trivially_destructible<balance_data>::value &&
+                      std::is_trivially_destructible<bst::detail::thread_node_data<Node, is_threaded>>::value &&
+                      bst::detail::supports_release<node_allocator_type>::value) {
+            if (root != nullptr && node_alloc_.in_use() == size_) {
+                node_alloc_.release();
+                return;
+            }
         }
+        destroy_subtree(root);
+    }
+
+    // Depth-first walk that calls `pre`, `in`, and `post` with each node at
+    // the matching visit; a callback returning `false` ends the walk early,
+    // and then walk() returns `false`. Uses bounded memory for any shape.
+    template <typename Pre, typename In, typename Post>
+    bool walk(Pre&& pre, In&& in, Post&& post) const {
+        return algorithms::walk(root_.get(), pre, in, post);
+    }
 
-        if (upper != nullptr && !compare_(node->value, *upper)) {
+    // Checks ordering in order, and every child's parent link before the
+    // walk can rely on it to climb back up.
+    bool is_valid_tree() const {
+        if (root_ != nullptr && root_->parent != nullptr) {
             return false;
         }
 
-        return is_valid_subtree(node->left.get(), lower, std::addressof(node->value)) &&
-               is_valid_subtree(node->right.get(), std::addressof(node->value), upper);
+        const Node* last_visited = nullptr;
+        const auto links_ok = [](const Node& node) {
+            return (node.left == nullptr || node.left->parent == &node) &&
+                   (node.right == nullptr || node.right->parent == &node);
+        };
+        const auto ordered = [this, &last_visited](const Node& node) {
+            if (last_visited != nullptr && !compare_(last_visited->value, node.value)) {
+                return false;
+            }
+            last_visited = &node;
+            return true;
+        };
+        return walk(links_ok, ordered, [](const Node&) { return true; });
     }
 };
 
-template <typename T, typename Compare>
-void swap(BinarySearchTree<T, Compare>& lhs, BinarySearchTree<T, Compare>& rhs) {
+template <typename T, typename Compare, typename Balance, typename Allocator>
+void swap(BinarySearchTree<T, Compare, Balance, Allocator>& lhs,
+          BinarySearchTree<T, Compare, Balance, Allocator>& rhs) {
     lhs.swap(rhs);
 }
 
+namespace bst {
+
+/**
+ * @brief `BinarySearchTree` of half-open intervals that answers overlap queries.
+ *
+ * Every node caches the largest upper endpoint in its subtree through
+ * `bst::augmented<bst::max_upper_endpoint<Interval, Traits>, Balance>`, so
+ * `overlapping()` and `for_each_overlapping()` skip subtrees that end too
+ * early. Everything else, including iterators and erase, is the ordinary
+ * tree. `Compare` must order intervals by lower endpoint first; the default
+ * `std::less` on `std::pair` does.
+ */
+template <typename Interval, typename Compare = std::less<Interval>, typename Balance = bst::red_black_balance,
+          typename Traits = bst::interval_traits<Interval>, typename Allocator = std::allocator<Interval>>
+using IntervalTree =
+    ::BinarySearchTree<Interval, Compare, bst::augmented<bst::max_upper_endpoint<Interval, Traits>, Balance>, Allocator>;
+
+} // namespace bst
+
+#if BST_HAS_MEMORY_RESOURCE
+namespace bst {
+namespace pmr {
+
+/**
+ * @brief `BinarySearchTree` that allocates nodes from a `std::pmr::memory_resource`.
+ *
+ * Allocator-aware values such as `std::pmr::string` are constructed with the
+ * same resource. A tree on a `std::pmr::monotonic_buffer_resource` never
+ * returns memory to the heap node by node; everything is released with the
+ * resource.
+ */
+template <typename T, typename Compare = std::less<T>, typename Balance = bst::no_balance>
+using BinarySearchTree = ::BinarySearchTree<T, Compare, Balance, std::pmr::polymorphic_allocator<T>>;
+
+} // namespace pmr
+} // namespace bst
+#endif
+
 #endif
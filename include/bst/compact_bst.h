@@ -0,0 +1,1146 @@
+#ifndef BST_COMPACT_BST_H
+#define BST_COMPACT_BST_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bst {
+
+/**
+ * @brief Link policy for `CompactBinarySearchTree` whose nodes store a parent index.
+ *
+ * Iterators are a single index and step through the tree by following parent
+ * links. This is the default.
+ */
+struct parent_links {};
+
+/**
+ * @brief Link policy for `CompactBinarySearchTree` whose nodes store only child indices.
+ *
+ * Each node is 4 bytes smaller and erase writes fewer links. Iterators keep
+ * the root-to-node path on a stack instead, which they rebuild with one
+ * descent the first time they move.
+ */
+struct parentless_links {};
+
+} // namespace bst
+
+/**
+ * @brief A Binary Search Tree whose nodes live in one contiguous vector.
+ *
+ * `CompactBinarySearchTree` offers the lookup, insertion, and iterator API
+ * of `BinarySearchTree`, but stores every node in a single `std::vector` and
+ * links nodes by 32-bit indices instead of pointers. A node costs 12 bytes
+ * plus the value (16 bytes in total for an `int`, against 32 for
+ * `BinarySearchTree<int>`), copies are a single vector copy, and lookups touch
+ * fewer cache lines.
+ *
+ * Like the default `BinarySearchTree`, the tree does not rebalance itself;
+ * range insertion links sorted batches in balanced and `rebalance()` reshapes
+ * the whole tree.
+ *
+ * @tparam T Stored value type. Must be move-assignable for erase.
+ * @tparam Compare Strict weak ordering used to compare values.
+ * @tparam Links `bst::parent_links` (default) or `bst::parentless_links`,
+ *         which drops the parent index from every node.
+ *
+ * @complexity
+ * Construction of an empty tree is O(1).
+ *
+ * @note
+ * Iterators refer to nodes by index, so insertion never invalidates them.
+ * Erasure moves the last node into the vacated slot and invalidates every
+ * iterator except the one it returns. The tree holds at most `2^32 - 1`
+ * elements.
+ */
+template <typename T, typename Compare = std::less<T>, typename Links = bst::parent_links>
+class CompactBinarySearchTree {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using link_policy = Links;
+
+private:
+    using index_type = std::uint32_t;
+
+    static constexpr index_type npos = std::numeric_limits<index_type>::max();
+    static constexpr bool has_parent = std::is_same<Links, bst::parent_links>::value;
+
+    static_assert(has_parent || std::is_same<Links, bst::parentless_links>::value,
+                  "CompactBinarySearchTree: unsupported link policy");
+
+    struct parent_slot {
+        index_type parent = npos;
+    };
+
+    struct no_parent_slot {};
+
+    struct Node : std::conditional_t<has_parent, parent_slot, no_parent_slot> {
+        value_type value;
+        index_type left;
+        index_type right;
+
+        template <typename... Args>
+        explicit Node(std::in_place_t, Args&&... args) : value(std::forward<Args>(args)...), left(npos), right(npos) {}
+    };
+
+    // Parentless iterators carry the root-to-node path; it stays empty until
+    // the iterator first moves.
+    struct index_cursor {};
+
+    struct path_cursor {
+        std::vector<index_type> path_;
+    };
+
+    std::vector<Node> nodes_;
+    index_type root_;
+    Compare compare_;
+
+    template <typename ValueType, typename Pointer, typename Reference>
+    class tree_iterator : private std::conditional_t<has_parent, index_cursor, path_cursor> {
+        using cursor = std::conditional_t<has_parent, index_cursor, path_cursor>;
+        using tree_pointer = std::conditional_t<std::is_const<ValueType>::value, const CompactBinarySearchTree*,
+                                                CompactBinarySearchTree*>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Pointer;
+        using reference = Reference;
+
+        tree_iterator() : index_(npos), tree_(nullptr) {}
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference,
+                  typename = std::enable_if_t<std::is_convertible<OtherPointer, Pointer>::value>>
+        tree_iterator(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other)
+            : cursor(other), index_(other.index_), tree_(other.tree_) {}
+
+        reference operator*() const {
+            return tree_->nodes_[index_].value;
+        }
+
+        pointer operator->() const {
+            return std::addressof(tree_->nodes_[index_].value);
+        }
+
+        tree_iterator& operator++() {
+            if (tree_ == nullptr) {
+                return *this;
+            }
+
+            if constexpr (has_parent) {
+                index_ = tree_->successor(index_);
+            } else if (index_ != npos) {
+                if (this->path_.empty()) {
+                    tree_->path_to(index_, this->path_);
+                }
+                index_ = tree_->path_successor(this->path_);
+            }
+            return *this;
+        }
+
+        tree_iterator operator++(int) {
+            tree_iterator copy(*this);
+            ++(*this);
+            return copy;
+        }
+
+        tree_iterator& operator--() {
+            if (tree_ == nullptr) {
+                return *this;
+            }
+
+            if constexpr (has_parent) {
+                if (index_ == npos) {
+                    index_ = tree_->max_index(tree_->root_);
+                } else {
+                    index_ = tree_->predecessor(index_);
+                }
+            } else {
+                if (index_ == npos) {
+                    index_ = tree_->path_to_max(this->path_);
+                } else {
+                    if (this->path_.empty()) {
+                        tree_->path_to(index_, this->path_);
+                    }
+                    index_ = tree_->path_predecessor(this->path_);
+                }
+            }
+            return *this;
+        }
+
+        tree_iterator operator--(int) {
+            tree_iterator copy(*this);
+            --(*this);
+            return copy;
+        }
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference>
+        bool operator==(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other) const {
+            return index_ == other.index_ && tree_ == other.tree_;
+        }
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference>
+        bool operator!=(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        index_type index_;
+        tree_pointer tree_;
+
+        explicit tree_iterator(index_type index, tree_pointer tree) : index_(index), tree_(tree) {}
+
+        template <typename, typename, typename>
+        friend class tree_iterator;
+        friend class CompactBinarySearchTree;
+    };
+
+public:
+    using iterator = tree_iterator<value_type, value_type*, value_type&>;
+    using const_iterator = tree_iterator<const value_type, const value_type*, const value_type&>;
+
+    /**
+     * @brief Constructs an empty tree.
+     *
+     * @param compare Comparison object used to order elements.
+     *
+     * @complexity
+     * Constant.
+     */
+    explicit CompactBinarySearchTree(const Compare& compare = Compare()) : root_(npos), compare_(compare) {}
+
+    /**
+     * @brief Constructs a tree from an iterator range.
+     *
+     * Duplicate values are ignored; the first of equivalent values is kept.
+     *
+     * @tparam InputIt Input iterator type.
+     * @param first Iterator to the first element in the range.
+     * @param last Iterator one past the last element in the range.
+     * @param compare Comparison object used to order elements.
+     *
+     * @complexity
+     * O(N log N); the tree is built balanced.
+     */
+    template <typename InputIt>
+    CompactBinarySearchTree(InputIt first, InputIt last, const Compare& compare = Compare())
+        : CompactBinarySearchTree(compare) {
+        insert(first, last);
+    }
+
+    /**
+     * @brief Constructs a tree from an initializer list.
+     *
+     * @param init Initial values to insert.
+     * @param compare Comparison object used to order elements.
+     *
+     * @complexity
+     * O(N log N); the tree is built balanced.
+     */
+    CompactBinarySearchTree(std::initializer_list<T> init, const Compare& compare = Compare())
+        : CompactBinarySearchTree(compare) {
+        insert(init.begin(), init.end());
+    }
+
+    /**
+     * @brief Swaps the contents of two trees.
+     *
+     * @param other Tree to swap with.
+     *
+     * @complexity
+     * Constant.
+     */
+    void swap(CompactBinarySearchTree& other) noexcept(std::is_nothrow_swappable<Compare>::value) {
+        using std::swap;
+        swap(nodes_, other.nodes_);
+        swap(root_, other.root_);
+        swap(compare_, other.compare_);
+    }
+
+    /**
+     * @brief Returns the number of stored elements.
+     *
+     * @complexity
+     * Constant.
+     */
+    size_type size() const noexcept {
+        return nodes_.size();
+    }
+
+    /**
+     * @brief Checks whether the tree is empty.
+     *
+     * @complexity
+     * Constant.
+     */
+    bool empty() const noexcept {
+        return nodes_.empty();
+    }
+
+    /**
+     * @brief Reserves node storage for `count` elements.
+     *
+     * @param count Number of elements the tree should hold without reallocating.
+     *
+     * @complexity
+     * At most linear in `size()`.
+     *
+     * @throws std::length_error If `count` exceeds the 32-bit index space.
+     */
+    void reserve(size_type count) {
+        if (count >= npos) {
+            throw std::length_error("CompactBinarySearchTree::reserve() exceeds the 32-bit index space");
+        }
+        nodes_.reserve(count);
+    }
+
+    /**
+     * @brief Removes all elements from the tree.
+     *
+     * The node storage is kept for reuse.
+     *
+     * @complexity
+     * Linear in `size()`.
+     */
+    void clear() noexcept {
+        nodes_.clear();
+        root_ = npos;
+    }
+
+    /**
+     * @brief Inserts a value by copying it.
+     *
+     * @param value The value to insert.
+     * @return std::pair<iterator, bool> Iterator to the inserted or existing
+     *         element, and whether insertion happened.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @throws std::length_error If the tree already holds `2^32 - 1` elements.
+     */
+    std::pair<iterator, bool> insert(const T& value) {
+        return insert_impl(value);
+    }
+
+    /**
+     * @brief Inserts a value by moving it.
+     *
+     * @param value The value to insert.
+     * @return std::pair<iterator, bool> Iterator to the inserted or existing
+     *         element, and whether insertion happened.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @throws std::length_error If the tree already holds `2^32 - 1` elements.
+     */
+    std::pair<iterator, bool> insert(T&& value) {
+        return insert_impl(std::move(value));
+    }
+
+    /**
+     * @brief Inserts each element in a range.
+     *
+     * The range is buffered and sorted. An empty tree is linked as a complete
+     * tree with nodes stored in sorted order; otherwise the batch is inserted
+     * median first. Among equivalent values the element already in the tree,
+     * or else the first one in the range, is kept.
+     *
+     * @tparam InputIt Input iterator type.
+     * @param first Iterator to the first element to insert.
+     * @param last Iterator one past the last element to insert.
+     *
+     * @complexity
+     * O(M log M) to sort M values, plus linear linking into an empty tree or
+     * M descents otherwise.
+     */
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        std::vector<T> batch(first, last);
+        std::stable_sort(batch.begin(), batch.end(),
+                         [this](const T& lhs, const T& rhs) { return compare_(lhs, rhs); });
+        batch.erase(std::unique(batch.begin(), batch.end(),
+                                [this](const T& lhs, const T& rhs) { return !compare_(lhs, rhs); }),
+                    batch.end());
+
+        if (empty()) {
+            reserve(batch.size());
+            for (T& value : batch) {
+                nodes_.emplace_back(std::in_place, std::move(value));
+            }
+            root_ = link_sorted(0, static_cast<index_type>(nodes_.size()), npos);
+        } else {
+            insert_median_first(batch, 0, batch.size());
+        }
+    }
+
+    /**
+     * @brief Constructs a value in place and inserts it.
+     *
+     * @tparam Args Constructor argument types for `T`.
+     * @param args Arguments forwarded to `T`'s constructor.
+     * @return std::pair<iterator, bool> Iterator to the inserted or existing
+     *         element, and whether insertion happened.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        T value(std::forward<Args>(args)...);
+        return insert_impl(std::move(value));
+    }
+
+    /**
+     * @brief Erases a value from the tree.
+     *
+     * @param value The value to erase.
+     * @return size_type `1` if an element was erased, otherwise `0`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    size_type erase(const T& value) {
+        const index_type index = find_index(value);
+        if (index == npos) {
+            return 0;
+        }
+
+        erase_index(index);
+        return 1;
+    }
+
+    /**
+     * @brief Erases the element at an iterator position.
+     *
+     * @param position Iterator pointing to the element to erase.
+     * @return iterator Iterator to the element that follows the erased one, or `end()`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     *
+     * @note
+     * Passing `end()` returns `end()`. Other iterators are invalidated.
+     */
+    iterator erase(const_iterator position) {
+        if (position.tree_ != this || position.index_ == npos) {
+            return end();
+        }
+
+        return iterator(erase_index(position.index_), this);
+    }
+
+    /**
+     * @brief Finds an element equal to `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator find(const T& value) {
+        return iterator(find_index(value), this);
+    }
+
+    /**
+     * @brief Finds an element equal to `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator find(const T& value) const {
+        return const_iterator(find_index(value), this);
+    }
+
+    /**
+     * @brief Checks whether the tree contains `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    bool contains(const T& value) const {
+        return find_index(value) != npos;
+    }
+
+    /**
+     * @brief Returns the first element not less than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator lower_bound(const T& value) {
+        return iterator(lower_bound_index(value), this);
+    }
+
+    /**
+     * @brief Returns the first element not less than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator lower_bound(const T& value) const {
+        return const_iterator(lower_bound_index(value), this);
+    }
+
+    /**
+     * @brief Returns the first element greater than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator upper_bound(const T& value) {
+        return iterator(upper_bound_index(value), this);
+    }
+
+    /**
+     * @brief Returns the first element greater than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator upper_bound(const T& value) const {
+        return const_iterator(upper_bound_index(value), this);
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    iterator begin() noexcept {
+        return iterator(min_index(root_), this);
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest element.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    const_iterator begin() const noexcept {
+        return const_iterator(min_index(root_), this);
+    }
+
+    /**
+     * @brief Returns a const iterator to the smallest element.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    /**
+     * @brief Returns the past-the-end iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    iterator end() noexcept {
+        return iterator(npos, this);
+    }
+
+    /**
+     * @brief Returns the past-the-end iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    const_iterator end() const noexcept {
+        return const_iterator(npos, this);
+    }
+
+    /**
+     * @brief Returns the past-the-end const iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief Returns the smallest value in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    const T& min() const {
+        if (empty()) {
+            throw std::out_of_range("CompactBinarySearchTree::min() called on an empty tree");
+        }
+        return nodes_[min_index(root_)].value;
+    }
+
+    /**
+     * @brief Returns the largest value in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    const T& max() const {
+        if (empty()) {
+            throw std::out_of_range("CompactBinarySearchTree::max() called on an empty tree");
+        }
+        return nodes_[max_index(root_)].value;
+    }
+
+    /**
+     * @brief Returns the number of nodes on the longest root-to-leaf path.
+     *
+     * @complexity
+     * Linear in `size()`. Constant extra space with parent links; without
+     * them the walk keeps an `O(height())` stack, which may allocate.
+     */
+    size_type height() const {
+        size_type height = 0;
+        size_type depth = 0;
+        walk([&depth, &height](const T&) {
+                 ++depth;
+                 height = depth > height ? depth : height;
+             },
+             [](const T&) {}, [&depth](const T&) { --depth; });
+        return height;
+    }
+
+    /**
+     * @brief Copies the tree contents into a sorted vector.
+     *
+     * @complexity
+     * Linear in `size()`.
+     */
+    std::vector<T> to_vector() const {
+        std::vector<T> values;
+        values.reserve(size());
+        in_order_traversal([&values](const T& value) {
+            values.push_back(value);
+        });
+        return values;
+    }
+
+    /**
+     * @brief Visits elements in sorted order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited element.
+     *
+     * @complexity
+     * Linear in `size()`. Constant extra space with parent links, an
+     * `O(height())` stack without them.
+     */
+    template <typename UnaryFunction>
+    void in_order_traversal(UnaryFunction&& function) const {
+        walk([](const T&) {}, function, [](const T&) {});
+    }
+
+    /**
+     * @brief Visits elements in Root-Left-Right order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited element.
+     *
+     * @complexity
+     * Linear in `size()`. Constant extra space with parent links, an
+     * `O(height())` stack without them.
+     */
+    template <typename UnaryFunction>
+    void pre_order_traversal(UnaryFunction&& function) const {
+        walk(function, [](const T&) {}, [](const T&) {});
+    }
+
+    /**
+     * @brief Visits elements in Left-Right-Root order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited element.
+     *
+     * @complexity
+     * Linear in `size()`. Constant extra space with parent links, an
+     * `O(height())` stack without them.
+     */
+    template <typename UnaryFunction>
+    void post_order_traversal(UnaryFunction&& function) const {
+        walk([](const T&) {}, [](const T&) {}, function);
+    }
+
+    /**
+     * @brief Verifies that in-order traversal yields strictly increasing values.
+     *
+     * Steps by node index rather than through iterators, so parentless trees
+     * do not copy a path per element.
+     *
+     * @complexity
+     * Linear in `size()`. Constant extra space with parent links, an
+     * `O(height())` stack without them.
+     */
+    bool is_valid_bst() const {
+        if constexpr (has_parent) {
+            index_type previous = min_index(root_);
+            if (previous == npos) {
+                return true;
+            }
+            for (index_type current = successor(previous); current != npos;
+                 previous = current, current = successor(current)) {
+                if (!compare_(nodes_[previous].value, nodes_[current].value)) {
+                    return false;
+                }
+            }
+            return true;
+        } else {
+            index_type previous = npos;
+            bool valid = true;
+            walk_indices([](index_type) {},
+                         [this, &previous, &valid](index_type current) {
+                             if (valid && previous != npos) {
+                                 valid = compare_(nodes_[previous].value, nodes_[current].value);
+                             }
+                             previous = current;
+                         },
+                         [](index_type) {});
+            return valid;
+        }
+    }
+
+    /**
+     * @brief Reshapes the tree into a complete binary tree.
+     *
+     * Nodes are permuted into sorted order inside the vector before they are
+     * relinked, so in-order scans afterwards walk memory sequentially.
+     * Iterators are invalidated.
+     *
+     * @complexity
+     * Linear in `size()`, with linear extra space.
+     */
+    void rebalance() {
+        // Record the order first: parentless stepping compares values, so
+        // nothing may be moved out until the walk is finished.
+        std::vector<index_type> order;
+        order.reserve(nodes_.size());
+        walk_indices([](index_type) {}, [&order](index_type index) { order.push_back(index); },
+                     [](index_type) {});
+
+        std::vector<Node> sorted;
+        sorted.reserve(nodes_.size());
+        for (index_type index : order) {
+            sorted.push_back(std::move(nodes_[index]));
+        }
+
+        nodes_.swap(sorted);
+        root_ = link_sorted(0, static_cast<index_type>(nodes_.size()), npos);
+    }
+
+private:
+    template <typename Value>
+    std::pair<iterator, bool> insert_impl(Value&& value) {
+        index_type parent = npos;
+        bool go_left = false;
+
+        for (index_type current = root_; current != npos;) {
+            parent = current;
+            if (compare_(value, nodes_[current].value)) {
+                go_left = true;
+                current = nodes_[current].left;
+            } else if (compare_(nodes_[current].value, value)) {
+                go_left = false;
+                current = nodes_[current].right;
+            } else {
+                return std::make_pair(iterator(current, this), false);
+            }
+        }
+
+        if (nodes_.size() >= npos - 1) {
+            throw std::length_error("CompactBinarySearchTree: 32-bit index space exhausted");
+        }
+
+        const index_type inserted = static_cast<index_type>(nodes_.size());
+        nodes_.emplace_back(std::in_place, std::forward<Value>(value));
+        set_parent(inserted, parent);
+        if (parent == npos) {
+            root_ = inserted;
+        } else if (go_left) {
+            nodes_[parent].left = inserted;
+        } else {
+            nodes_[parent].right = inserted;
+        }
+        return std::make_pair(iterator(inserted, this), true);
+    }
+
+    // Inserts batch[first, last) median first, so each gap between existing
+    // keys receives a balanced subtree rather than a chain.
+    void insert_median_first(std::vector<T>& batch, size_type first, size_type last) {
+        if (first == last) {
+            return;
+        }
+
+        const size_type middle = first + (last - first) / 2;
+        insert_impl(std::move(batch[middle]));
+        insert_median_first(batch, first, middle);
+        insert_median_first(batch, middle + 1, last);
+    }
+
+    // Links nodes [first, last), already stored in sorted order, into a
+    // complete subtree and returns its root.
+    index_type link_sorted(index_type first, index_type last, index_type parent) noexcept {
+        if (first == last) {
+            return npos;
+        }
+
+        const index_type middle = first + (last - first) / 2;
+        set_parent(middle, parent);
+        Node& node = nodes_[middle];
+        node.left = link_sorted(first, middle, middle);
+        node.right = link_sorted(middle + 1, last, middle);
+        return middle;
+    }
+
+    // Removes the node at `index` and returns the index of its in-order
+    // successor after the removal, or `npos`.
+    index_type erase_index(index_type index) {
+        index_type parent = npos;
+        index_type next = npos;
+        locate(index, parent, next);
+
+        if (nodes_[index].left != npos && nodes_[index].right != npos) {
+            // The successor has no left child: move its value up and remove
+            // the successor's slot instead.
+            parent = index;
+            next = nodes_[index].right;
+            while (nodes_[next].left != npos) {
+                parent = next;
+                next = nodes_[next].left;
+            }
+            nodes_[index].value = std::move(nodes_[next].value);
+            std::swap(index, next);
+        }
+
+        const index_type child = nodes_[index].left != npos ? nodes_[index].left : nodes_[index].right;
+        if (child != npos) {
+            set_parent(child, parent);
+        }
+        replace_child(parent, index, child);
+
+        // Fill the hole with the last node so storage stays contiguous.
+        const index_type last = static_cast<index_type>(nodes_.size() - 1);
+        if (index != last) {
+            index_type last_parent = npos;
+            index_type unused = npos;
+            locate(last, last_parent, unused);
+
+            nodes_[index] = std::move(nodes_[last]);
+            replace_child(last_parent, last, index);
+            if constexpr (has_parent) {
+                if (nodes_[index].left != npos) {
+                    nodes_[nodes_[index].left].parent = index;
+                }
+                if (nodes_[index].right != npos) {
+                    nodes_[nodes_[index].right].parent = index;
+                }
+            }
+            if (next == last) {
+                next = index;
+            }
+        }
+        nodes_.pop_back();
+        return next;
+    }
+
+    // Finds the parent and in-order successor of the node at `index`: through
+    // parent links, or with one descent by key when nodes have none.
+    void locate(index_type index, index_type& parent, index_type& next) const {
+        if constexpr (has_parent) {
+            parent = nodes_[index].parent;
+            next = successor(index);
+        } else {
+            parent = npos;
+            next = npos;
+            for (index_type current = root_; current != index;) {
+                parent = current;
+                if (compare_(nodes_[index].value, nodes_[current].value)) {
+                    next = current;
+                    current = nodes_[current].left;
+                } else {
+                    current = nodes_[current].right;
+                }
+            }
+            if (nodes_[index].right != npos) {
+                next = min_index(nodes_[index].right);
+            }
+        }
+    }
+
+    void set_parent(index_type index, index_type parent) noexcept {
+        if constexpr (has_parent) {
+            nodes_[index].parent = parent;
+        } else {
+            (void)index;
+            (void)parent;
+        }
+    }
+
+    // Path-based stepping for parentless iterators. `path` runs from the
+    // root to the current node.
+    void path_to(index_type index, std::vector<index_type>& path) const {
+        path.clear();
+        for (index_type current = root_;;) {
+            path.push_back(current);
+            if (current == index) {
+                return;
+            }
+            current = compare_(nodes_[index].value, nodes_[current].value) ? nodes_[current].left
+                                                                            : nodes_[current].right;
+        }
+    }
+
+    index_type path_to_max(std::vector<index_type>& path) const {
+        path.clear();
+        for (index_type current = root_; current != npos; current = nodes_[current].right) {
+            path.push_back(current);
+        }
+        return path.empty() ? npos : path.back();
+    }
+
+    index_type path_successor(std::vector<index_type>& path) const {
+        index_type current = path.back();
+        if (nodes_[current].right != npos) {
+            for (current = nodes_[current].right; current != npos; current = nodes_[current].left) {
+                path.push_back(current);
+            }
+            return path.back();
+        }
+
+        path.pop_back();
+        while (!path.empty() && nodes_[path.back()].right == current) {
+            current = path.back();
+            path.pop_back();
+        }
+        return path.empty() ? npos : path.back();
+    }
+
+    index_type path_predecessor(std::vector<index_type>& path) const {
+        index_type current = path.back();
+        if (nodes_[current].left != npos) {
+            for (current = nodes_[current].left; current != npos; current = nodes_[current].right) {
+                path.push_back(current);
+            }
+            return path.back();
+        }
+
+        path.pop_back();
+        while (!path.empty() && nodes_[path.back()].left == current) {
+            current = path.back();
+            path.pop_back();
+        }
+        return path.empty() ? npos : path.back();
+    }
+
+    void replace_child(index_type parent, index_type old_child, index_type new_child) noexcept {
+        if (parent == npos) {
+            root_ = new_child;
+        } else if (nodes_[parent].left == old_child) {
+            nodes_[parent].left = new_child;
+        } else {
+            nodes_[parent].right = new_child;
+        }
+    }
+
+    index_type find_index(const T& value) const {
+        index_type current = root_;
+        while (current != npos) {
+            if (compare_(value, nodes_[current].value)) {
+                current = nodes_[current].left;
+            } else if (compare_(nodes_[current].value, value)) {
+                current = nodes_[current].right;
+            } else {
+                return current;
+            }
+        }
+        return npos;
+    }
+
+    index_type lower_bound_index(const T& value) const {
+        index_type current = root_;
+        index_type candidate = npos;
+        while (current != npos) {
+            if (!compare_(nodes_[current].value, value)) {
+                candidate = current;
+                current = nodes_[current].left;
+            } else {
+                current = nodes_[current].right;
+            }
+        }
+        return candidate;
+    }
+
+    index_type upper_bound_index(const T& value) const {
+        index_type current = root_;
+        index_type candidate = npos;
+        while (current != npos) {
+            if (compare_(value, nodes_[current].value)) {
+                candidate = current;
+                current = nodes_[current].left;
+            } else {
+                current = nodes_[current].right;
+            }
+        }
+        return candidate;
+    }
+
+    index_type min_index(index_type index) const noexcept {
+        if (index == npos) {
+            return npos;
+        }
+        while (nodes_[index].left != npos) {
+            index = nodes_[index].left;
+        }
+        return index;
+    }
+
+    index_type max_index(index_type index) const noexcept {
+        if (index == npos) {
+            return npos;
+        }
+        while (nodes_[index].right != npos) {
+            index = nodes_[index].right;
+        }
+        return index;
+    }
+
+    index_type successor(index_type index) const noexcept {
+        if (index == npos) {
+            return npos;
+        }
+        if (nodes_[index].right != npos) {
+            return min_index(nodes_[index].right);
+        }
+
+        index_type parent = nodes_[index].parent;
+        while (parent != npos && nodes_[parent].right == index) {
+            index = parent;
+            parent = nodes_[parent].parent;
+        }
+        return parent;
+    }
+
+    index_type predecessor(index_type index) const noexcept {
+        if (index == npos) {
+            return npos;
+        }
+        if (nodes_[index].left != npos) {
+            return max_index(nodes_[index].left);
+        }
+
+        index_type parent = nodes_[index].parent;
+        while (parent != npos && nodes_[parent].left == index) {
+            index = parent;
+            parent = nodes_[parent].parent;
+        }
+        return parent;
+    }
+
+    // Depth-first walk that calls `pre`, `in`, and `post` at the matching
+    // visit of each node.
+    template <typename Pre, typename In, typename Post>
+    void walk(Pre&& pre, In&& in, Post&& post) const {
+        walk_indices([this, &pre](index_type index) { pre(nodes_[index].value); },
+                     [this, &in](index_type index) { in(nodes_[index].value); },
+                     [this, &post](index_type index) { post(nodes_[index].value); });
+    }
+
+    // Same walk over node indices. Follows parent links without recursion, or
+    // keeps an explicit stack when nodes have none. Only links are read, so
+    // callbacks may inspect values without disturbing the walk.
+    template <typename Pre, typename In, typename Post>
+    void walk_indices(Pre&& pre, In&& in, Post&& post) const {
+        if constexpr (has_parent) {
+            index_type previous = npos;
+            index_type current = root_;
+
+            while (current != npos) {
+                const Node& node = nodes_[current];
+                index_type next;
+                if (previous == node.parent) {
+                    pre(current);
+                    if (node.left != npos) {
+                        next = node.left;
+                    } else {
+                        in(current);
+                        next = node.right;
+                    }
+                } else if (previous == node.left) {
+                    in(current);
+                    next = node.right;
+                } else {
+                    next = npos;
+                }
+
+                if (next == npos) {
+                    post(current);
+                    next = node.parent;
+                }
+                previous = current;
+                current = next;
+            }
+        } else {
+            // Each entry holds a node and how many of its visits are done.
+            std::vector<std::pair<index_type, unsigned char>> stack;
+            if (root_ != npos) {
+                pre(root_);
+                stack.emplace_back(root_, 0);
+            }
+            while (!stack.empty()) {
+                const index_type current = stack.back().first;
+                const Node& node = nodes_[current];
+                unsigned char& state = stack.back().second;
+                if (state == 0) {
+                    state = 1;
+                    if (node.left != npos) {
+                        pre(node.left);
+                        stack.emplace_back(node.left, 0);
+                        continue;
+                    }
+                }
+                if (state == 1) {
+                    state = 2;
+                    in(current);
+                    if (node.right != npos) {
+                        pre(node.right);
+                        stack.emplace_back(node.right, 0);
+                        continue;
+                    }
+                }
+                post(current);
+                stack.pop_back();
+            }
+        }
+    }
+};
+
+template <typename T, typename Compare, typename Links>
+void swap(CompactBinarySearchTree<T, Compare, Links>& lhs,
+          CompactBinarySearchTree<T, Compare, Links>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+#endif
@@ -0,0 +1,373 @@
+#ifndef BST_DETAIL_TREE_ALGORITHMS_H
+#define BST_DETAIL_TREE_ALGORITHMS_H
+
+#include <cstddef>
+
+namespace bst {
+namespace detail {
+
+/**
+ * @brief Binary search tree algorithms shared by every pointer-linked tree.
+ *
+ * `BinarySearchTree` and `IntrusiveBinarySearchTree` store their links
+ * differently (owning child pointers in a node, or a hook embedded in the
+ * caller's object), so the algorithms reach them only through `Links`:
+ *
+ * - `node_type`, and `link_type`, the type a node stores a child link in.
+ * - `left(p)`, `right(p)`, and `parent(p)`: the neighbours of `p`, which may
+ *   be a pointer to const.
+ * - `left_link(p)` and `right_link(p)`: the child slots of a mutable `p`.
+ * - `get(link)` and `set(link, p)`: read and write a child slot.
+ * - `set_parent(p, parent)`: write a parent link.
+ * - `value(p)`: the value ordered by the comparator.
+ * - `update(p)`: refreshes metadata cached in `p` after its children changed.
+ *
+ * @tparam Links Link accessor policy described above.
+ */
+template <typename Links>
+struct tree_algorithms {
+    using node_type = typename Links::node_type;
+    using link_type = typename Links::link_type;
+    using size_type = std::size_t;
+
+    // Lookups work on pointers to const or mutable nodes alike.
+    template <typename NodePointer>
+    static NodePointer min_node(NodePointer node) noexcept {
+        while (node != nullptr && Links::left(node) != nullptr) {
+            node = Links::left(node);
+        }
+        return node;
+    }
+
+    template <typename NodePointer>
+    static NodePointer max_node(NodePointer node) noexcept {
+        while (node != nullptr && Links::right(node) != nullptr) {
+            node = Links::right(node);
+        }
+        return node;
+    }
+
+    template <typename NodePointer>
+    static NodePointer successor(NodePointer node) noexcept {
+        if (node == nullptr) {
+            return nullptr;
+        }
+
+        if (Links::right(node) != nullptr) {
+            return min_node<NodePointer>(Links::right(node));
+        }
+
+        NodePointer parent = Links::parent(node);
+        while (parent != nullptr && Links::right(parent) == node) {
+            node = parent;
+            parent = Links::parent(parent);
+        }
+        return parent;
+    }
+
+    template <typename NodePointer>
+    static NodePointer predecessor(NodePointer node) noexcept {
+        if (node == nullptr) {
+            return nullptr;
+        }
+
+        if (Links::left(node) != nullptr) {
+            return max_node<NodePointer>(Links::left(node));
+        }
+
+        NodePointer parent = Links::parent(node);
+        while (parent != nullptr && Links::left(parent) == node) {
+            node = parent;
+            parent = Links::parent(parent);
+        }
+        return parent;
+    }
+
+    // `last_visited`, when given, receives the node where a search ended.
+    template <typename Value, typename Compare>
+    static node_type* find(node_type* root, const Value& value, const Compare& compare,
+                           node_type** last_visited = nullptr) {
+        node_type* current = root;
+        while (current != nullptr) {
+            if (last_visited != nullptr) {
+                *last_visited = current;
+            }
+            if (compare(value, Links::value(current))) {
+                current = Links::left(current);
+            } else if (compare(Links::value(current), value)) {
+                current = Links::right(current);
+            } else {
+                return current;
+            }
+        }
+        return nullptr;
+    }
+
+    template <typename Value, typename Compare>
+    static node_type* lower_bound(node_type* root, const Value& value, const Compare& compare,
+                                  node_type** last_visited = nullptr) {
+        node_type* current = root;
+        node_type* candidate = nullptr;
+        while (current != nullptr) {
+            if (last_visited != nullptr) {
+                *last_visited = current;
+            }
+            if (!compare(Links::value(current), value)) {
+                candidate = current;
+                current = Links::left(current);
+            } else {
+                current = Links::right(current);
+            }
+        }
+        return candidate;
+    }
+
+    template <typename Value, typename Compare>
+    static node_type* upper_bound(node_type* root, const Value& value, const Compare& compare) {
+        node_type* current = root;
+        node_type* candidate = nullptr;
+        while (current != nullptr) {
+            if (compare(value, Links::value(current))) {
+                candidate = current;
+                current = Links::left(current);
+            } else {
+                current = Links::right(current);
+            }
+        }
+        return candidate;
+    }
+
+    // Descends to the slot where `value` belongs. The slot holds the
+    // equivalent node if there is one and is empty otherwise, ready for a
+    // new leaf. `parent` receives the node owning the slot (null for `root`)
+    // and `depth`, when given, the number of nodes stepped through.
+    template <typename Value, typename Compare>
+    static link_type* insert_position(link_type& root, const Value& value, const Compare& compare,
+                                      node_type*& parent, size_type* depth = nullptr) {
+        link_type* link = &root;
+        size_type steps = 0;
+        parent = nullptr;
+        while (Links::get(*link) != nullptr) {
+            node_type* current = Links::get(*link);
+            if (compare(value, Links::value(current))) {
+                link = &Links::left_link(current);
+            } else if (compare(Links::value(current), value)) {
+                link = &Links::right_link(current);
+            } else {
+                break;
+            }
+            parent = current;
+            ++steps;
+        }
+        if (depth != nullptr) {
+            *depth = steps;
+        }
+        return link;
+    }
+
+    // Returns the slot that holds `node`: `root`, or a child link of its parent.
+    static link_type& link_to(node_type* node, link_type& root) noexcept {
+        node_type* parent = Links::parent(node);
+        if (parent == nullptr) {
+            return root;
+        }
+        return Links::left(parent) == node ? Links::left_link(parent) : Links::right_link(parent);
+    }
+
+    // Puts `replacement` (possibly null) where `node` hangs from its parent.
+    // `node` keeps its own links.
+    static void transplant(node_type* node, node_type* replacement, link_type& root) noexcept {
+        node_type* parent = Links::parent(node);
+        Links::set(link_to(node, root), replacement);
+        if (replacement != nullptr) {
+            Links::set_parent(replacement, parent);
+        }
+    }
+
+    // Detaches `node` and clears its child links; its parent link goes stale.
+    // A node with two children is replaced by its in-order successor, so no
+    // other node moves. Returns the node now in `node`'s place. `fix_parent`
+    // receives the lowest node whose children changed and `fix_child` the
+    // node that took the slot which physically lost a node; either may be
+    // null.
+    static node_type* unlink(node_type* node, link_type& root, node_type*& fix_parent,
+                             node_type*& fix_child) noexcept {
+        node_type* left = Links::left(node);
+        node_type* right = Links::right(node);
+        node_type* replacement;
+
+        if (left == nullptr || right == nullptr) {
+            replacement = left != nullptr ? left : right;
+            fix_parent = Links::parent(node);
+            fix_child = replacement;
+            transplant(node, replacement, root);
+        } else {
+            replacement = min_node(right);
+            fix_child = Links::right(replacement);
+            if (replacement == right) {
+                fix_parent = replacement;
+            } else {
+                fix_parent = Links::parent(replacement);
+                transplant(replacement, fix_child, root);
+                Links::set(Links::right_link(replacement), right);
+                Links::set_parent(right, replacement);
+            }
+            transplant(node, replacement, root);
+            Links::set(Links::left_link(replacement), left);
+            Links::set_parent(left, replacement);
+        }
+
+        Links::set(Links::left_link(node), nullptr);
+        Links::set(Links::right_link(node), nullptr);
+        return replacement;
+    }
+
+    // Rotates the subtree held by `link` to the left and returns its new root.
+    static node_type* rotate_left(link_type& link) noexcept {
+        node_type* node = Links::get(link);
+        node_type* raised = Links::right(node);
+        node_type* inner = Links::left(raised);
+
+        Links::set(Links::right_link(node), inner);
+        if (inner != nullptr) {
+            Links::set_parent(inner, node);
+        }
+        Links::set_parent(raised, Links::parent(node));
+        Links::set_parent(node, raised);
+        Links::set(Links::left_link(raised), node);
+        Links::set(link, raised);
+
+        Links::update(node);
+        Links::update(raised);
+        return raised;
+    }
+
+    // Rotates the subtree held by `link` to the right and returns its new root.
+    static node_type* rotate_right(link_type& link) noexcept {
+        node_type* node = Links::get(link);
+        node_type* raised = Links::left(node);
+        node_type* inner = Links::right(raised);
+
+        Links::set(Links::left_link(node), inner);
+        if (inner != nullptr) {
+            Links::set_parent(inner, node);
+        }
+        Links::set_parent(raised, Links::parent(node));
+        Links::set_parent(node, raised);
+        Links::set(Links::right_link(raised), node);
+        Links::set(link, raised);
+
+        Links::update(node);
+        Links::update(raised);
+        return raised;
+    }
+
+    // Relinks the `count` nodes held by `link` into a complete binary tree
+    // with Day-Stout-Warren: rotate into a right-leaning vine, then compress
+    // it level by level. O(count) time, O(1) extra space, no recursion.
+    // Nodes keep their addresses, so iterators stay valid.
+    static void rebuild(link_type& link, size_type count) noexcept {
+        tree_to_vine(link);
+        vine_to_tree(link, count);
+    }
+
+    static void tree_to_vine(link_type& root) noexcept {
+        link_type* link = &root;
+        while (Links::get(*link) != nullptr) {
+            if (Links::left(Links::get(*link)) != nullptr) {
+                rotate_right(*link);
+            } else {
+                link = &Links::right_link(Links::get(*link));
+            }
+        }
+    }
+
+    static void vine_to_tree(link_type& link, size_type count) noexcept {
+        size_type full = 1;
+        while (full <= count + 1) {
+            full *= 2;
+        }
+        full = full / 2 - 1;
+
+        // Place the leftover bottom-level leaves first so the result is complete.
+        compress_vine(link, count - full);
+        while (full > 1) {
+            full /= 2;
+            compress_vine(link, full);
+        }
+    }
+
+    static void compress_vine(link_type& root, size_type rotations) noexcept {
+        link_type* link = &root;
+        for (size_type i = 0; i < rotations; ++i) {
+            node_type* raised = rotate_left(*link);
+            link = &Links::right_link(raised);
+        }
+    }
+
+    // Depth-first walk that calls `pre`, `in`, and `post` with each node at
+    // the matching visit; a callback returning `false` ends the walk early,
+    // and then walk() returns `false`. The way back up comes from a fixed-size
+    // stack of the deepest ancestors, so nothing recurses. On paths deeper
+    // than that stack the walk climbs through parent links instead, which is
+    // slower but keeps memory bounded for any tree shape.
+    template <typename Pre, typename In, typename Post>
+    static bool walk(const node_type* root, Pre&& pre, In&& in, Post&& post) {
+        constexpr size_type capacity = 64;
+        const node_type* path[capacity];
+        size_type top = 0;
+        size_type kept = 0;
+
+        enum class arrival { from_parent, from_left, from_right };
+        const node_type* current = root;
+        arrival state = arrival::from_parent;
+
+        while (current != nullptr) {
+            if (state == arrival::from_parent) {
+                if (!pre(*current)) {
+                    return false;
+                }
+                if (Links::left(current) != nullptr) {
+                    path[top++ % capacity] = current;
+                    kept += kept < capacity ? 1 : 0;
+                    current = Links::left(current);
+                    continue;
+                }
+                state = arrival::from_left;
+            }
+            if (state == arrival::from_left) {
+                if (!in(*current)) {
+                    return false;
+                }
+                if (Links::right(current) != nullptr) {
+                    path[top++ % capacity] = current;
+                    kept += kept < capacity ? 1 : 0;
+                    current = Links::right(current);
+                    state = arrival::from_parent;
+                    continue;
+                }
+            }
+            if (!post(*current)) {
+                return false;
+            }
+
+            const node_type* parent;
+            if (kept != 0) {
+                parent = path[--top % capacity];
+                --kept;
+            } else {
+                parent = Links::parent(current);
+            }
+            if (parent != nullptr) {
+                state = Links::left(parent) == current ? arrival::from_left : arrival::from_right;
+            }
+            current = parent;
+        }
+        return true;
+    }
+};
+
+} // namespace detail
+} // namespace bst
+
+#endif
@@ -0,0 +1,826 @@
+#ifndef BST_INTRUSIVE_BST_H
+#define BST_INTRUSIVE_BST_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "detail/tree_algorithms.h"
+
+namespace bst {
+
+/**
+ * @brief Links that let an `IntrusiveBinarySearchTree` hold an object.
+ *
+ * Embed one hook per tree the object can belong to, either as a public base
+ * class (`struct Order : bst::intrusive_hook<Order>`) or as a data member
+ * selected with `bst::member_hook`. The tree owns only the links; a hook
+ * must not be shared by two trees at once.
+ *
+ * @tparam T Type of the object that embeds the hook.
+ */
+template <typename T>
+struct intrusive_hook {
+    T* left = nullptr;
+    T* right = nullptr;
+    T* parent = nullptr;
+};
+
+/**
+ * @brief Hook policy for objects that derive from `bst::intrusive_hook<T>`.
+ *
+ * This is the default.
+ */
+struct base_hook {};
+
+/**
+ * @brief Hook policy for objects that store `bst::intrusive_hook<T>` as a data member.
+ *
+ * @tparam T Type of the object that embeds the hook.
+ * @tparam Member Pointer to the hook member, e.g. `&Session::by_id`.
+ */
+template <typename T, intrusive_hook<T> T::*Member>
+struct member_hook {};
+
+namespace detail {
+
+template <typename T, typename Hook>
+struct hook_access;
+
+template <typename T>
+struct hook_access<T, base_hook> {
+    static_assert(std::is_base_of<intrusive_hook<T>, T>::value,
+                  "bst::base_hook requires T to derive from bst::intrusive_hook<T>");
+
+    static intrusive_hook<T>& get(T& value) noexcept {
+        return value;
+    }
+
+    static const intrusive_hook<T>& get(const T& value) noexcept {
+        return value;
+    }
+};
+
+template <typename T, intrusive_hook<T> T::*Member>
+struct hook_access<T, member_hook<T, Member>> {
+    static intrusive_hook<T>& get(T& value) noexcept {
+        return value.*Member;
+    }
+
+    static const intrusive_hook<T>& get(const T& value) noexcept {
+        return value.*Member;
+    }
+};
+
+// Link accessors that let `tree_algorithms` walk objects through their hooks.
+template <typename T, typename Hook>
+struct hook_links {
+    using node_type = T;
+    using link_type = T*;
+    using access = hook_access<T, Hook>;
+
+    static T* left(const T* node) noexcept {
+        return access::get(*node).left;
+    }
+
+    static T* right(const T* node) noexcept {
+        return access::get(*node).right;
+    }
+
+    static T* parent(const T* node) noexcept {
+        return access::get(*node).parent;
+    }
+
+    static T*& left_link(T* node) noexcept {
+        return access::get(*node).left;
+    }
+
+    static T*& right_link(T* node) noexcept {
+        return access::get(*node).right;
+    }
+
+    static T* get(T* link) noexcept {
+        return link;
+    }
+
+    static void set(T*& link, T* node) noexcept {
+        link = node;
+    }
+
+    static void set_parent(T* node, T* parent) noexcept {
+        access::get(*node).parent = parent;
+    }
+
+    static const T& value(const T* node) noexcept {
+        return *node;
+    }
+
+    // Hooks cache nothing besides links.
+    static void update(T*) noexcept {}
+};
+
+} // namespace detail
+
+} // namespace bst
+
+/**
+ * @brief A Binary Search Tree that links caller-owned objects in place.
+ *
+ * `IntrusiveBinarySearchTree` offers the lookup, insertion, and iterator API
+ * of `BinarySearchTree`, but never copies, allocates, or destroys values.
+ * Each object carries its own `bst::intrusive_hook<T>`, and insertion and
+ * erasure only rewrite the three pointers in the hooks involved. Objects can
+ * therefore live in an existing pool, array, or arena while being indexed by
+ * the tree, and `iterator_to()` turns an object reference back into an
+ * iterator without a search.
+ *
+ * Like the default `BinarySearchTree`, the tree does not rebalance itself;
+ * `rebalance()` reshapes the whole tree in place.
+ *
+ * @tparam T Stored object type.
+ * @tparam Compare Strict weak ordering used to compare objects.
+ * @tparam Hook `bst::base_hook` (default) when `T` derives from
+ *         `bst::intrusive_hook<T>`, or `bst::member_hook<T, &T::member>`.
+ *
+ * @complexity
+ * Construction of an empty tree is O(1).
+ *
+ * @note
+ * Linked objects must outlive their membership in the tree and must not be
+ * moved while linked. Iterators stay valid until their element is erased.
+ * The tree is move-only because two trees cannot share one set of hooks.
+ */
+template <typename T, typename Compare = std::less<T>, typename Hook = bst::base_hook>
+class IntrusiveBinarySearchTree {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using value_compare = Compare;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using hook_type = bst::intrusive_hook<T>;
+
+private:
+    using access = bst::detail::hook_access<T, Hook>;
+    using algorithms = bst::detail::tree_algorithms<bst::detail::hook_links<T, Hook>>;
+
+    T* root_;
+    size_type size_;
+    Compare compare_;
+
+    template <typename ValueType, typename Pointer, typename Reference>
+    class tree_iterator {
+        using tree_pointer = std::conditional_t<std::is_const<ValueType>::value, const IntrusiveBinarySearchTree*,
+                                                IntrusiveBinarySearchTree*>;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Pointer;
+        using reference = Reference;
+
+        tree_iterator() : node_(nullptr), tree_(nullptr) {}
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference,
+                  typename = std::enable_if_t<std::is_convertible<OtherPointer, Pointer>::value>>
+        tree_iterator(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other)
+            : node_(other.node_), tree_(other.tree_) {}
+
+        reference operator*() const {
+            return *node_;
+        }
+
+        pointer operator->() const {
+            return node_;
+        }
+
+        tree_iterator& operator++() {
+            if (tree_ != nullptr) {
+                node_ = tree_->successor(node_);
+            }
+            return *this;
+        }
+
+        tree_iterator operator++(int) {
+            tree_iterator copy(*this);
+            ++(*this);
+            return copy;
+        }
+
+        tree_iterator& operator--() {
+            if (tree_ == nullptr) {
+                return *this;
+            }
+
+            if (node_ == nullptr) {
+                node_ = tree_->max_node(tree_->root_);
+            } else {
+                node_ = tree_->predecessor(node_);
+            }
+            return *this;
+        }
+
+        tree_iterator operator--(int) {
+            tree_iterator copy(*this);
+            --(*this);
+            return copy;
+        }
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference>
+        bool operator==(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other) const {
+            return node_ == other.node_ && tree_ == other.tree_;
+        }
+
+        template <typename OtherValueType, typename OtherPointer, typename OtherReference>
+        bool operator!=(const tree_iterator<OtherValueType, OtherPointer, OtherReference>& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        T* node_;
+        tree_pointer tree_;
+
+        explicit tree_iterator(T* node, tree_pointer tree) : node_(node), tree_(tree) {}
+
+        template <typename, typename, typename>
+        friend class tree_iterator;
+        friend class IntrusiveBinarySearchTree;
+    };
+
+public:
+    using iterator = tree_iterator<value_type, value_type*, value_type&>;
+    using const_iterator = tree_iterator<const value_type, const value_type*, const value_type&>;
+
+    /**
+     * @brief Constructs an empty tree.
+     *
+     * @param compare Comparison object used to order objects.
+     *
+     * @complexity
+     * Constant.
+     */
+    explicit IntrusiveBinarySearchTree(const Compare& compare = Compare())
+        : root_(nullptr), size_(0), compare_(compare) {}
+
+    IntrusiveBinarySearchTree(const IntrusiveBinarySearchTree&) = delete;
+    IntrusiveBinarySearchTree& operator=(const IntrusiveBinarySearchTree&) = delete;
+
+    /**
+     * @brief Takes over every object linked into another tree.
+     *
+     * @param other Tree to move from. It is left empty.
+     *
+     * @complexity
+     * Constant.
+     */
+    IntrusiveBinarySearchTree(IntrusiveBinarySearchTree&& other) noexcept(
+        std::is_nothrow_move_constructible<Compare>::value)
+        : root_(std::exchange(other.root_, nullptr)),
+          size_(std::exchange(other.size_, 0)),
+          compare_(std::move(other.compare_)) {}
+
+    /**
+     * @brief Unlinks the current objects and takes over those of another tree.
+     *
+     * @param other Tree to move from. It is left empty.
+     * @return IntrusiveBinarySearchTree& Reference to `*this`.
+     *
+     * @complexity
+     * Constant.
+     */
+    IntrusiveBinarySearchTree& operator=(IntrusiveBinarySearchTree&& other) noexcept(
+        std::is_nothrow_move_assignable<Compare>::value) {
+        if (this != &other) {
+            root_ = std::exchange(other.root_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            compare_ = std::move(other.compare_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Swaps the contents of two trees.
+     *
+     * @param other Tree to swap with.
+     *
+     * @complexity
+     * Constant.
+     */
+    void swap(IntrusiveBinarySearchTree& other) noexcept(std::is_nothrow_swappable<Compare>::value) {
+        using std::swap;
+        swap(root_, other.root_);
+        swap(size_, other.size_);
+        swap(compare_, other.compare_);
+    }
+
+    /**
+     * @brief Returns the number of linked objects.
+     *
+     * @complexity
+     * Constant.
+     */
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    /**
+     * @brief Checks whether the tree is empty.
+     *
+     * @complexity
+     * Constant.
+     */
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    /**
+     * @brief Unlinks every object.
+     *
+     * The objects themselves are left untouched; their hooks keep stale
+     * pointers until they are inserted again.
+     *
+     * @complexity
+     * Constant.
+     */
+    void clear() noexcept {
+        root_ = nullptr;
+        size_ = 0;
+    }
+
+    /**
+     * @brief Links an object into the tree.
+     *
+     * Nothing is copied or allocated; only the hooks of `value` and its new
+     * parent are written.
+     *
+     * @param value The object to link. Its hook must not be linked into
+     *        another tree through the same hook.
+     * @return std::pair<iterator, bool> Iterator to `value` or to the
+     *         equivalent object already linked, and whether insertion
+     *         happened.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    std::pair<iterator, bool> insert(T& value) {
+        T* parent;
+        T** link = algorithms::insert_position(root_, value, compare_, parent);
+        if (*link != nullptr) {
+            return {iterator(*link, this), false};
+        }
+
+        hook_type& links = hook(std::addressof(value));
+        links.left = nullptr;
+        links.right = nullptr;
+        links.parent = parent;
+        *link = std::addressof(value);
+        ++size_;
+        return {iterator(std::addressof(value), this), true};
+    }
+
+    /**
+     * @brief Links each object in a range.
+     *
+     * @tparam ForwardIt Forward iterator whose `operator*` yields `T&`.
+     * @param first Iterator to the first object to link.
+     * @param last Iterator one past the last object to link.
+     *
+     * @complexity
+     * One descent per object.
+     */
+    template <typename ForwardIt>
+    void insert(ForwardIt first, ForwardIt last) {
+        for (; first != last; ++first) {
+            insert(*first);
+        }
+    }
+
+    /**
+     * @brief Unlinks the object equal to `value`.
+     *
+     * @param value Key of the object to unlink.
+     * @return size_type `1` if an object was unlinked, otherwise `0`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    size_type erase(const T& value) {
+        T* node = find_node(value);
+        if (node == nullptr) {
+            return 0;
+        }
+
+        unlink(node);
+        return 1;
+    }
+
+    /**
+     * @brief Unlinks the object at an iterator position.
+     *
+     * @param position Iterator pointing to the object to unlink.
+     * @return iterator Iterator to the object that follows the unlinked one, or `end()`.
+     *
+     * @complexity
+     * Constant relinking plus one successor step: O(height) at worst.
+     *
+     * @note
+     * Passing `end()` returns `end()`. Only iterators to the unlinked object
+     * are invalidated.
+     */
+    iterator erase(const_iterator position) {
+        if (position.tree_ != this || position.node_ == nullptr) {
+            return end();
+        }
+
+        return iterator(unlink(position.node_), this);
+    }
+
+    /**
+     * @brief Returns an iterator to an object that is linked into this tree.
+     *
+     * @param value An object currently linked into `*this`.
+     *
+     * @complexity
+     * Constant.
+     */
+    iterator iterator_to(T& value) noexcept {
+        return iterator(std::addressof(value), this);
+    }
+
+    /**
+     * @brief Returns a const iterator to an object that is linked into this tree.
+     *
+     * @param value An object currently linked into `*this`.
+     *
+     * @complexity
+     * Constant.
+     */
+    const_iterator iterator_to(const T& value) const noexcept {
+        return const_iterator(const_cast<T*>(std::addressof(value)), this);
+    }
+
+    /**
+     * @brief Finds an object equal to `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator find(const T& value) {
+        return iterator(find_node(value), this);
+    }
+
+    /**
+     * @brief Finds an object equal to `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator find(const T& value) const {
+        return const_iterator(find_node(value), this);
+    }
+
+    /**
+     * @brief Checks whether an object equal to `value` is linked.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    bool contains(const T& value) const {
+        return find_node(value) != nullptr;
+    }
+
+    /**
+     * @brief Returns the first object not less than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator lower_bound(const T& value) {
+        return iterator(lower_bound_node(value), this);
+    }
+
+    /**
+     * @brief Returns the first object not less than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator lower_bound(const T& value) const {
+        return const_iterator(lower_bound_node(value), this);
+    }
+
+    /**
+     * @brief Returns the first object greater than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    iterator upper_bound(const T& value) {
+        return iterator(upper_bound_node(value), this);
+    }
+
+    /**
+     * @brief Returns the first object greater than `value`.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N) when the tree is highly unbalanced.
+     */
+    const_iterator upper_bound(const T& value) const {
+        return const_iterator(upper_bound_node(value), this);
+    }
+
+    /**
+     * @brief Returns an iterator to the smallest object.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    iterator begin() noexcept {
+        return iterator(min_node(root_), this);
+    }
+
+    /**
+     * @brief Returns a const iterator to the smallest object.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    const_iterator begin() const noexcept {
+        return const_iterator(min_node(root_), this);
+    }
+
+    /**
+     * @brief Returns a const iterator to the smallest object.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     */
+    const_iterator cbegin() const noexcept {
+        return begin();
+    }
+
+    /**
+     * @brief Returns the past-the-end iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    iterator end() noexcept {
+        return iterator(nullptr, this);
+    }
+
+    /**
+     * @brief Returns the past-the-end const iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    const_iterator end() const noexcept {
+        return const_iterator(nullptr, this);
+    }
+
+    /**
+     * @brief Returns the past-the-end const iterator.
+     *
+     * @complexity
+     * Constant.
+     */
+    const_iterator cend() const noexcept {
+        return end();
+    }
+
+    /**
+     * @brief Returns the smallest object in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    T& min() {
+        if (empty()) {
+            throw std::out_of_range("IntrusiveBinarySearchTree::min() called on an empty tree");
+        }
+        return *min_node(root_);
+    }
+
+    /**
+     * @brief Returns the smallest object in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    const T& min() const {
+        if (empty()) {
+            throw std::out_of_range("IntrusiveBinarySearchTree::min() called on an empty tree");
+        }
+        return *min_node(root_);
+    }
+
+    /**
+     * @brief Returns the largest object in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    T& max() {
+        if (empty()) {
+            throw std::out_of_range("IntrusiveBinarySearchTree::max() called on an empty tree");
+        }
+        return *max_node(root_);
+    }
+
+    /**
+     * @brief Returns the largest object in the tree.
+     *
+     * @complexity
+     * Average: O(log N). Worst: O(N).
+     *
+     * @throws std::out_of_range If the tree is empty.
+     */
+    const T& max() const {
+        if (empty()) {
+            throw std::out_of_range("IntrusiveBinarySearchTree::max() called on an empty tree");
+        }
+        return *max_node(root_);
+    }
+
+    /**
+     * @brief Returns the number of nodes on the longest root-to-leaf path.
+     *
+     * @complexity
+     * Linear in `size()`, constant extra space.
+     */
+    size_type height() const noexcept {
+        size_type height = 0;
+        size_type depth = 0;
+        walk(
+            [&depth, &height](const T&) {
+                ++depth;
+                height = depth > height ? depth : height;
+                return true;
+            },
+            skip,
+            [&depth](const T&) {
+                --depth;
+                return true;
+            });
+        return height;
+    }
+
+    /**
+     * @brief Visits objects in sorted order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited object.
+     *
+     * @complexity
+     * Linear in `size()`, constant extra space.
+     */
+    template <typename UnaryFunction>
+    void in_order_traversal(UnaryFunction&& function) const {
+        walk(skip, visit(function), skip);
+    }
+
+    /**
+     * @brief Visits objects in Root-Left-Right order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited object.
+     *
+     * @complexity
+     * Linear in `size()`, constant extra space.
+     */
+    template <typename UnaryFunction>
+    void pre_order_traversal(UnaryFunction&& function) const {
+        walk(visit(function), skip, skip);
+    }
+
+    /**
+     * @brief Visits objects in Left-Right-Root order.
+     *
+     * @tparam UnaryFunction Callable type accepting `const T&`.
+     * @param function Callable invoked for each visited object.
+     *
+     * @complexity
+     * Linear in `size()`, constant extra space.
+     */
+    template <typename UnaryFunction>
+    void post_order_traversal(UnaryFunction&& function) const {
+        walk(skip, skip, visit(function));
+    }
+
+    /**
+     * @brief Verifies that in-order traversal yields strictly increasing objects.
+     *
+     * @complexity
+     * Linear in `size()`.
+     */
+    bool is_valid_bst() const {
+        const T* previous = nullptr;
+        const auto ordered = [this, &previous](const T& current) {
+            if (previous != nullptr && !compare_(*previous, current)) {
+                return false;
+            }
+            previous = std::addressof(current);
+            return true;
+        };
+        return walk(skip, ordered, skip);
+    }
+
+    /**
+     * @brief Reshapes the tree into a complete binary tree in place.
+     *
+     * Uses the Day-Stout-Warren algorithm on the hooks, so nothing is
+     * allocated and iterators stay valid. Afterwards `height()` is
+     * `ceil(log2(size() + 1))`.
+     *
+     * @complexity
+     * Linear in `size()` with constant extra space.
+     */
+    void rebalance() noexcept {
+        algorithms::rebuild(root_, size_);
+    }
+
+private:
+    static hook_type& hook(T* node) noexcept {
+        return access::get(*node);
+    }
+
+    static bool skip(const T&) noexcept {
+        return true;
+    }
+
+    // Adapts a traversal callback to walk(), which expects `bool`.
+    template <typename UnaryFunction>
+    static auto visit(UnaryFunction& function) {
+        return [&function](const T& value) {
+            function(value);
+            return true;
+        };
+    }
+
+    // Unlinks `node` and returns its in-order successor. A node with two
+    // children is replaced by that successor, so no other object moves.
+    T* unlink(T* node) noexcept {
+        T* next = successor(node);
+        T* fix_parent = nullptr;
+        T* fix_child = nullptr;
+        algorithms::unlink(node, root_, fix_parent, fix_child);
+        hook(node).parent = nullptr;
+        --size_;
+        return next;
+    }
+
+    T* find_node(const T& value) const {
+        return algorithms::find(root_, value, compare_);
+    }
+
+    T* lower_bound_node(const T& value) const {
+        return algorithms::lower_bound(root_, value, compare_);
+    }
+
+    T* upper_bound_node(const T& value) const {
+        return algorithms::upper_bound(root_, value, compare_);
+    }
+
+    static T* min_node(T* node) noexcept {
+        return algorithms::min_node(node);
+    }
+
+    static T* max_node(T* node) noexcept {
+        return algorithms::max_node(node);
+    }
+
+    static T* successor(T* node) noexcept {
+        return algorithms::successor(node);
+    }
+
+    static T* predecessor(T* node) noexcept {
+        return algorithms::predecessor(node);
+    }
+
+    template <typename Pre, typename In, typename Post>
+    bool walk(Pre&& pre, In&& in, Post&& post) const {
+        return algorithms::walk(root_, pre, in, post);
+    }
+};
+
+template <typename T, typename Compare, typename Hook>
+void swap(IntrusiveBinarySearchTree<T, Compare, Hook>& lhs,
+          IntrusiveBinarySearchTree<T, Compare, Hook>& rhs) noexcept(noexcept(lhs.swap(rhs))) {
+    lhs.swap(rhs);
+}
+
+#endif
@@ -1,5 +1,8 @@
 #include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cassert>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
 #include <string>
@@ -7,6 +10,8 @@
 #include <vector>
 
 #include <bst/bst.h>
+#include <bst/compact_bst.h>
+#include <bst/intrusive_bst.h>
 
 struct Record {
     int id;
@@ -25,6 +30,103 @@ struct DescendingInt {
     }
 };
 
+struct Order : bst::intrusive_hook<Order> {
+    int id = 0;
+
+    bool operator<(const Order& other) const {
+        return id < other.id;
+    }
+};
+
+struct Session {
+    int id = 0;
+    bst::intrusive_hook<Session> by_id;
+};
+
+struct SessionById {
+    bool operator()(const Session& lhs, const Session& rhs) const {
+        return lhs.id < rhs.id;
+    }
+};
+
+struct PriceLevel {
+    int price = 0;
+    long long quantity = 0;
+
+    bool operator<(const PriceLevel& other) const {
+        return price < other.price;
+    }
+};
+
+struct QuantitySum {
+    using value_type = long long;
+
+    static value_type identity() {
+        return 0;
+    }
+
+    static value_type project(const PriceLevel& level) {
+        return level.quantity;
+    }
+
+    static value_type combine(value_type lhs, value_type rhs) {
+        return lhs + rhs;
+    }
+};
+
+struct Digits {
+    using value_type = std::string;
+
+    static value_type identity() {
+        return std::string();
+    }
+
+    static value_type project(int value) {
+        return std::to_string(value);
+    }
+
+    static value_type combine(const value_type& lhs, const value_type& rhs) {
+        return lhs + rhs;
+    }
+};
+
+// Aggregate whose summaries count their live instances, to catch nodes whose
+// metadata is never destroyed.
+struct Tally {
+    static inline int live = 0;
+    long long total;
+
+    Tally(long long value = 0) : total(value) {
+        ++live;
+    }
+
+    Tally(const Tally& other) : total(other.total) {
+        ++live;
+    }
+
+    Tally& operator=(const Tally&) = default;
+
+    ~Tally() {
+        --live;
+    }
+};
+
+struct TallySum {
+    using value_type = Tally;
+
+    static value_type identity() {
+        return Tally();
+    }
+
+    static value_type project(int value) {
+        return Tally(value);
+    }
+
+    static value_type combine(const value_type& lhs, const value_type& rhs) {
+        return Tally(lhs.total + rhs.total);
+    }
+};
+
 void test_default_constructor();
 void test_initializer_list_constructor();
 void test_range_constructor();
@@ -50,6 +152,34 @@ void test_move_assignment();
 void test_traversal_methods();
 void test_min_max_height_to_vector();
 void test_bounds_and_validity();
+void test_avl_sorted_insert_stays_balanced();
+void test_avl_erase_keeps_balance();
+void test_red_black_sorted_insert_stays_balanced();
+void test_red_black_insert_erase_churn();
+void test_splay_moves_accessed_keys_to_root();
+void test_treap_sorted_insert_and_erase();
+void test_treap_split_and_join();
+void test_scapegoat_sorted_insert_and_erase();
+void test_rebalance_sorted_tree();
+void test_rebuild_threshold();
+void test_sorted_unique_construction();
+void test_range_insert_builds_balanced_tree();
+void test_pool_allocator_reuses_slabs();
+void test_pmr_allocator_and_copies();
+void test_compact_tree();
+void test_compact_tree_without_parent_links();
+void test_threaded_iteration();
+void test_intrusive_tree();
+void test_node_handles();
+void test_merge_splices_nodes();
+void test_clear_degenerate_tree();
+void test_copy_degenerate_tree();
+void test_traversals_on_degenerate_tree();
+void test_early_exit_and_range_visits();
+void test_order_statistics();
+void test_count_in_range();
+void test_range_aggregates();
+void test_interval_tree();
 
 int main() {
     test_default_constructor();
@@ -77,6 +207,34 @@ int main() {
     test_traversal_methods();
     test_min_max_height_to_vector();
     test_bounds_and_validity();
+    test_avl_sorted_insert_stays_balanced();
+    test_avl_erase_keeps_balance();
+    test_red_black_sorted_insert_stays_balanced();
+    test_red_black_insert_erase_churn();
+    test_splay_moves_accessed_keys_to_root();
+    test_treap_sorted_insert_and_erase();
+    test_treap_split_and_join();
+    test_scapegoat_sorted_insert_and_erase();
+    test_rebalance_sorted_tree();
+    test_rebuild_threshold();
+    test_sorted_unique_construction();
+    test_range_insert_builds_balanced_tree();
+    test_pool_allocator_reuses_slabs();
+    test_pmr_allocator_and_copies();
+    test_compact_tree();
+    test_compact_tree_without_parent_links();
+    test_threaded_iteration();
+    test_intrusive_tree();
+    test_node_handles();
+    test_merge_splices_nodes();
+    test_clear_degenerate_tree();
+    test_copy_degenerate_tree();
+    test_traversals_on_degenerate_tree();
+    test_early_exit_and_range_visits();
+    test_order_statistics();
+    test_count_in_range();
+    test_range_aggregates();
+    test_interval_tree();
 
     std::cout << "All BinarySearchTree tests passed." << std::endl;
     return 0;
@@ -287,6 +445,11 @@ void test_copy_constructor() {
     copy.insert(12);
     assert(!original.contains(12));
     assert(copy.contains(12));
+
+    const BinarySearchTree<std::string> words = {"a string too long for small-string storage", "b"};
+    BinarySearchTree<std::string> words_copy(words);
+    assert(words_copy.to_vector() == words.to_vector());
+    assert(words.min() == "a string too long for small-string storage");
 }
 
 void test_copy_assignment() {
@@ -368,3 +531,1148 @@ void test_bounds_and_validity() {
     assert(bst.upper_bound(40) == bst.end());
     assert(bst.is_valid_bst());
 }
+
+void test_avl_sorted_insert_stays_balanced() {
+    BinarySearchTree<int, std::less<int>, bst::avl_balance> bst;
+    for (int value = 0; value < 1000; ++value) {
+        bst.insert(value);
+    }
+
+    assert(bst.size() == 1000);
+    assert(bst.height() <= 14);
+    assert(bst.is_valid_bst());
+    assert(*bst.find(500) == 500);
+    assert(*bst.lower_bound(999) == 999);
+
+    BinarySearchTree<int, std::less<int>, bst::avl_balance> descending;
+    for (int value = 1000; value > 0; --value) {
+        descending.insert(value);
+    }
+    assert(descending.height() <= 14);
+    assert(descending.is_valid_bst());
+}
+
+void test_avl_erase_keeps_balance() {
+    BinarySearchTree<int, std::less<int>, bst::avl_balance> bst;
+    for (int value = 0; value < 1024; ++value) {
+        bst.insert(value);
+    }
+
+    for (int value = 0; value < 1024; value += 3) {
+        assert(bst.erase(value) == 1);
+    }
+    for (auto it = bst.begin(); it != bst.end();) {
+        it = *it % 2 == 0 ? bst.erase(it) : std::next(it);
+    }
+
+    std::vector<int> expected;
+    for (int value = 0; value < 1024; ++value) {
+        if (value % 3 != 0 && value % 2 != 0) {
+            expected.push_back(value);
+        }
+    }
+
+    assert(bst.to_vector() == expected);
+    assert(bst.size() == expected.size());
+    assert(bst.height() <= 12);
+    assert(bst.is_valid_bst());
+}
+
+void test_red_black_sorted_insert_stays_balanced() {
+    BinarySearchTree<int, std::less<int>, bst::red_black_balance> bst;
+    for (int value = 0; value < 1000; ++value) {
+        bst.insert(value);
+    }
+
+    assert(bst.size() == 1000);
+    assert(bst.height() <= 19);
+    assert(bst.is_valid_bst());
+    assert(*bst.find(750) == 750);
+    assert(*bst.upper_bound(998) == 999);
+}
+
+void test_red_black_insert_erase_churn() {
+    BinarySearchTree<int, std::less<int>, bst::red_black_balance> bst;
+    std::vector<int> expected;
+
+    for (int round = 0; round < 8; ++round) {
+        for (int value = round * 200; value < round * 200 + 400; ++value) {
+            bst.insert(value);
+        }
+        for (int value = round * 200; value < round * 200 + 200; ++value) {
+            assert(bst.erase(value) == 1);
+        }
+    }
+    for (int value = 1600; value < 1800; ++value) {
+        expected.push_back(value);
+    }
+
+    assert(bst.to_vector() == expected);
+    assert(bst.height() <= 16);
+    assert(bst.is_valid_bst());
+}
+
+void test_splay_moves_accessed_keys_to_root() {
+    using SplayTree = BinarySearchTree<int, std::less<int>, bst::splay_balance>;
+    SplayTree bst;
+    for (int value = 0; value < 500; ++value) {
+        bst.insert(value);
+    }
+
+    std::vector<int> pre_order;
+    bst.find(17);
+    bst.pre_order_traversal([&pre_order](const int value) { pre_order.push_back(value); });
+    assert(pre_order.front() == 17);
+
+    pre_order.clear();
+    assert(*bst.lower_bound(250) == 250);
+    bst.pre_order_traversal([&pre_order](const int value) { pre_order.push_back(value); });
+    assert(pre_order.front() == 250);
+
+    const SplayTree& view = bst;
+    assert(*view.find(3) == 3);
+    pre_order.clear();
+    bst.pre_order_traversal([&pre_order](const int value) { pre_order.push_back(value); });
+    assert(pre_order.front() == 250);
+
+    assert(bst.erase(250) == 1);
+    assert(bst.size() == 499);
+    assert(bst.is_valid_bst());
+
+    std::vector<int> expected;
+    for (int value = 0; value < 500; ++value) {
+        if (value != 250) {
+            expected.push_back(value);
+        }
+    }
+    assert(bst.to_vector() == expected);
+}
+
+void test_treap_sorted_insert_and_erase() {
+    BinarySearchTree<int, std::less<int>, bst::treap_balance> bst;
+    for (int value = 0; value < 2000; ++value) {
+        bst.insert(value);
+    }
+
+    assert(bst.size() == 2000);
+    assert(bst.height() < 100);
+    assert(bst.is_valid_bst());
+
+    for (int value = 0; value < 2000; value += 2) {
+        assert(bst.erase(value) == 1);
+    }
+    assert(bst.size() == 1000);
+    assert(*bst.begin() == 1);
+    assert(bst.is_valid_bst());
+}
+
+void test_treap_split_and_join() {
+    using Treap = BinarySearchTree<int, std::less<int>, bst::treap_balance>;
+    Treap lower;
+    for (int value = 0; value < 100; ++value) {
+        lower.insert(value);
+    }
+
+    const int* address = &*lower.find(70);
+    Treap upper = lower.split(60);
+    assert(lower.size() == 60);
+    assert(upper.size() == 40);
+    assert(lower.max() == 59);
+    assert(*upper.begin() == 60);
+    assert(&*upper.find(70) == address);
+    assert(lower.is_valid_bst());
+    assert(upper.is_valid_bst());
+
+    lower.join(std::move(upper));
+    assert(upper.empty());
+    assert(lower.size() == 100);
+    assert(lower.to_vector().back() == 99);
+    assert(lower.is_valid_bst());
+
+    Treap overlapping = {50};
+    bool threw = false;
+    try {
+        lower.join(std::move(overlapping));
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(overlapping.size() == 1);
+}
+
+void test_scapegoat_sorted_insert_and_erase() {
+    BinarySearchTree<int, std::less<int>, bst::scapegoat_balance<>> bst;
+    for (int value = 0; value < 4096; ++value) {
+        bst.insert(value);
+    }
+
+    assert(bst.size() == 4096);
+    assert(bst.height() <= 22);
+    assert(bst.is_valid_bst());
+
+    const int* address = &*bst.find(1234);
+    for (int value = 0; value < 4096; ++value) {
+        if (value % 8 != 2) {
+            assert(bst.erase(value) == 1);
+        }
+    }
+
+    assert(bst.size() == 512);
+    assert(bst.height() <= 17);
+    assert(&*bst.find(1234) == address);
+    assert(bst.is_valid_bst());
+}
+
+void test_rebalance_sorted_tree() {
+    BinarySearchTree<int> bst;
+    for (int value = 0; value < 1000; ++value) {
+        bst.insert(value);
+    }
+    assert(bst.height() == 1000);
+
+    const auto position = bst.find(500);
+    bst.rebalance();
+    assert(bst.height() == 10);
+    assert(bst.size() == 1000);
+    assert(bst.is_valid_bst());
+    assert(*position == 500);
+    assert(*std::next(position) == 501);
+
+    std::vector<int> expected;
+    for (int value = 0; value < 1000; ++value) {
+        expected.push_back(value);
+    }
+    assert(bst.to_vector() == expected);
+
+    BinarySearchTree<int> small = {3, 2, 1};
+    small.rebalance();
+    assert(small.height() == 2);
+
+    BinarySearchTree<int> empty;
+    empty.rebalance();
+    assert(empty.empty());
+    assert(empty.height() == 0);
+}
+
+void test_rebuild_threshold() {
+    BinarySearchTree<int> bst;
+    assert(bst.rebuild_threshold() == 0.0);
+    bst.set_rebuild_threshold(2.0);
+    assert(bst.rebuild_threshold() == 2.0);
+
+    const auto first = bst.insert(0).first;
+    for (int value = 1; value < 4096; ++value) {
+        bst.insert(value);
+        if (value % 512 == 0) {
+            assert(bst.height() <= 2 * 12 + 1);
+        }
+    }
+
+    assert(bst.size() == 4096);
+    assert(bst.height() <= 25);
+    assert(bst.is_valid_bst());
+    assert(*first == 0);
+    assert(bst.to_vector().back() == 4095);
+
+    bool threw = false;
+    try {
+        bst.set_rebuild_threshold(0.5);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(bst.rebuild_threshold() == 2.0);
+
+    BinarySearchTree<int> copy(bst);
+    assert(copy.rebuild_threshold() == 2.0);
+    for (int value = 4096; value < 8192; ++value) {
+        copy.insert(value);
+    }
+    assert(static_cast<double>(copy.height()) <= 2.0 * std::log2(8192.0) + 1.0);
+
+    // Enabling the threshold on a tall tree brings it within the bound.
+    BinarySearchTree<int> chain;
+    for (int value = 0; value < 1000; ++value) {
+        chain.insert(value);
+    }
+    chain.set_rebuild_threshold(1.5);
+    assert(static_cast<double>(chain.height()) <= 1.5 * std::log2(1000.0) + 1.0);
+
+    // The bound holds after every insertion for every supported policy.
+    const auto within_bound = [](const auto& tree) {
+        return static_cast<double>(tree.height()) <= 1.5 * std::log2(static_cast<double>(tree.size())) + 1.0;
+    };
+    BinarySearchTree<int, std::less<int>, bst::threaded<bst::no_balance>> threaded_tree;
+    BinarySearchTree<int, std::less<int>, bst::order_statistics<bst::no_balance>> counted_tree;
+    BinarySearchTree<PriceLevel, std::less<PriceLevel>, bst::augmented<QuantitySum, bst::no_balance>> summed_tree;
+    threaded_tree.set_rebuild_threshold(1.5);
+    counted_tree.set_rebuild_threshold(1.5);
+    summed_tree.set_rebuild_threshold(1.5);
+    for (int value = 0; value < 2048; ++value) {
+        const int key = value % 2 == 0 ? value : 4096 - value;
+        threaded_tree.insert(key);
+        counted_tree.insert(key);
+        summed_tree.insert(PriceLevel{key, 1});
+        assert(within_bound(threaded_tree));
+        assert(within_bound(counted_tree));
+        assert(within_bound(summed_tree));
+    }
+    assert(threaded_tree.is_valid_bst());
+    assert(*counted_tree.nth(1000) == counted_tree.to_vector()[1000]);
+    assert(summed_tree.aggregate() == 2048);
+
+    bst.set_rebuild_threshold(0.0);
+    BinarySearchTree<int> untracked(bst);
+    assert(untracked.rebuild_threshold() == 0.0);
+}
+
+void test_sorted_unique_construction() {
+    std::vector<int> values;
+    for (int value = 0; value < 1000; ++value) {
+        values.push_back(value * 2);
+    }
+
+    BinarySearchTree<int> bst(bst::sorted_unique, values.begin(), values.end());
+    assert(bst.size() == 1000);
+    assert(bst.height() == 10);
+    assert(bst.to_vector() == values);
+    assert(bst.is_valid_bst());
+    assert(*bst.lower_bound(5) == 6);
+
+    BinarySearchTree<int, std::less<int>, bst::red_black_balance> red_black(bst::sorted_unique, values.begin(),
+                                                                           values.end());
+    assert(red_black.height() == 10);
+    for (int value = 1; value < 2000; value += 2) {
+        red_black.insert(value);
+    }
+    assert(red_black.size() == 2000);
+    assert(red_black.is_valid_bst());
+
+    BinarySearchTree<int, std::less<int>, bst::treap_balance> treap(bst::sorted_unique, values.begin(), values.end());
+    assert(treap.to_vector() == values);
+    BinarySearchTree<int, std::less<int>, bst::treap_balance> upper = treap.split(1000);
+    assert(treap.size() == 500);
+    assert(upper.size() == 500);
+
+    const std::vector<int> replacement = {1, 2, 3};
+    bst.assign(bst::sorted_unique, replacement.begin(), replacement.end());
+    assert(bst.to_vector() == replacement);
+    assert(bst.height() == 2);
+
+    const std::vector<int> unsorted = {1, 3, 2};
+    bool threw = false;
+    try {
+        bst.assign(bst::sorted_unique, unsorted.begin(), unsorted.end());
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    assert(threw);
+    assert(bst.to_vector() == replacement);
+}
+
+void test_range_insert_builds_balanced_tree() {
+    std::vector<int> ascending;
+    for (int value = 0; value < 10000; ++value) {
+        ascending.push_back(value);
+    }
+
+    BinarySearchTree<int> bst(ascending.begin(), ascending.end());
+    assert(bst.size() == 10000);
+    assert(bst.height() == 14);
+    assert(bst.is_valid_bst());
+
+    std::vector<int> mixed = {20005, 3, 20001, 20003, 9999, 20002, 20004, 20000};
+    bst.insert(mixed.begin(), mixed.end());
+    assert(bst.size() == 10006);
+    assert(bst.max() == 20005);
+    assert(bst.is_valid_bst());
+
+    std::vector<int> overlapping;
+    for (int value = 15000; value > 5000; --value) {
+        overlapping.push_back(value);
+    }
+    bst.insert(overlapping.begin(), overlapping.end());
+    assert(bst.size() == 15007);
+    assert(bst.height() == 14);
+    assert(bst.is_valid_bst());
+
+    BinarySearchTree<Record> records;
+    records.emplace(2, "existing");
+    const std::vector<Record> incoming = {Record{3, "first"}, Record{2, "ignored"}, Record{1, "one"},
+                                          Record{3, "second"}};
+    records.insert(incoming.begin(), incoming.end());
+    assert(records.size() == 3);
+    assert(records.find(Record{2, ""})->name == "existing");
+    assert(records.find(Record{3, ""})->name == "first");
+}
+
+void test_pool_allocator_reuses_slabs() {
+    using PooledTree = BinarySearchTree<int, std::less<int>, bst::avl_balance, bst::pool_allocator<int>>;
+
+    bst::pool_allocator<int> pool;
+    PooledTree bst(std::less<int>(), pool);
+    bst.reserve(1000);
+    for (int value = 0; value < 1000; ++value) {
+        bst.insert(value);
+    }
+    assert(pool.in_use() == 1000);
+
+    for (int value = 0; value < 1000; value += 2) {
+        bst.erase(value);
+    }
+    assert(pool.in_use() == 500);
+
+    PooledTree copy(bst);
+    assert(pool.in_use() == 1000);
+    assert(copy.to_vector() == bst.to_vector());
+
+    copy.clear();
+    assert(pool.in_use() == 500);
+    assert(bst.size() == 500);
+    assert(bst.is_valid_bst());
+
+    bst.clear();
+    assert(pool.in_use() == 0);
+    bst.insert(3);
+    bst.insert(1);
+    bst.insert(2);
+    assert(pool.in_use() == 3);
+    assert(bst.to_vector() == std::vector<int>({1, 2, 3}));
+
+    // A value-sized request before any node must not shut nodes out of the pool.
+    bst::pool_allocator<int> shared;
+    int* loose = shared.allocate(1);
+    PooledTree mixed(std::less<int>(), shared);
+    mixed.reserve(100);
+    for (int value = 0; value < 100; ++value) {
+        mixed.insert(value);
+    }
+    assert(shared.in_use() == 101);
+    shared.deallocate(loose, 1);
+    mixed.clear();
+    assert(shared.in_use() == 0);
+
+    // Summaries with destructors rule out dropping whole slabs.
+    {
+        BinarySearchTree<int, std::less<int>, bst::augmented<TallySum, bst::avl_balance>, bst::pool_allocator<int>>
+            tallied;
+        for (int value = 0; value < 100; ++value) {
+            tallied.insert(value);
+        }
+        assert(tallied.aggregate().total == 4950);
+    }
+    assert(Tally::live == 0);
+
+    BinarySearchTree<std::string, std::less<std::string>, bst::no_balance, bst::pool_allocator<std::string>> words;
+    words.insert("pear");
+    words.insert("apple");
+    words.erase("pear");
+    assert(words.size() == 1);
+    assert(*words.begin() == "apple");
+}
+
+void test_pmr_allocator_and_copies() {
+    BinarySearchTree<int, std::less<int>, bst::avl_balance> balanced;
+    for (int value = 0; value < 1000; ++value) {
+        balanced.insert(value);
+    }
+    BinarySearchTree<int, std::less<int>, bst::avl_balance> balanced_copy(balanced);
+    for (int value = 1000; value < 3000; ++value) {
+        balanced_copy.insert(value);
+    }
+    for (int value = 0; value < 1500; ++value) {
+        balanced_copy.erase(value);
+    }
+    assert(balanced_copy.size() == 1500);
+    assert(balanced_copy.height() <= 15);
+
+#if BST_HAS_MEMORY_RESOURCE
+    std::array<std::byte, 64 * 1024> buffer;
+    // Any allocation that escapes the arena throws.
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    bst::pmr::BinarySearchTree<std::pmr::string, std::less<std::pmr::string>, bst::red_black_balance> names(&arena);
+    for (int id = 0; id < 200; ++id) {
+        names.emplace("request-scoped-name-" + std::to_string(id));
+    }
+    assert(names.size() == 200);
+    assert(names.get_allocator().resource() == &arena);
+    assert(names.begin()->get_allocator().resource() == &arena);
+
+    decltype(names) same_arena(names, &arena);
+    assert(same_arena.size() == 200);
+    assert(same_arena.begin()->get_allocator().resource() == &arena);
+
+    decltype(names) on_heap(std::move(same_arena), std::pmr::new_delete_resource());
+    assert(on_heap.size() == 200);
+    assert(same_arena.empty());
+    assert(on_heap.begin()->get_allocator().resource() == std::pmr::new_delete_resource());
+
+    names = on_heap;
+    assert(names.get_allocator().resource() == &arena);
+    assert(names.to_vector() == on_heap.to_vector());
+
+    // Range insertion buffers its batch in the tree's resource too.
+    std::vector<std::pmr::string> long_names;
+    for (int id = 0; id < 1000; ++id) {
+        long_names.emplace_back("a-name-long-enough-to-skip-the-small-string-buffer-" + std::to_string(id * 7919 % 1000));
+    }
+    std::vector<std::byte> batch_buffer(1024 * 1024);
+    std::pmr::monotonic_buffer_resource batch_arena(batch_buffer.data(), batch_buffer.size(),
+                                                    std::pmr::null_memory_resource());
+    std::pmr::memory_resource* previous_default = std::pmr::set_default_resource(std::pmr::null_memory_resource());
+    decltype(names) batched(&batch_arena);
+    batched.insert(long_names.begin(), long_names.end());
+    batched.insert(long_names.begin(), long_names.begin() + 500);
+    std::pmr::set_default_resource(previous_default);
+    assert(batched.size() == 1000);
+    assert(batched.is_valid_bst());
+    assert(batched.begin()->get_allocator().resource() == &batch_arena);
+#endif
+}
+
+void test_compact_tree() {
+    CompactBinarySearchTree<int> compact = {50, 30, 70, 20, 40, 60, 80};
+    assert(compact.size() == 7);
+    assert(compact.height() == 3);
+    assert(compact.contains(40));
+    assert(!compact.contains(45));
+    assert(*compact.lower_bound(45) == 50);
+    assert(*compact.upper_bound(50) == 60);
+    assert(compact.min() == 20);
+    assert(compact.max() == 80);
+
+    const auto inserted = compact.insert(45);
+    assert(inserted.second);
+    assert(!compact.insert(45).second);
+    assert(*inserted.first == 45);
+
+    std::vector<int> pre_order;
+    compact.pre_order_traversal([&pre_order](int value) {
+        pre_order.push_back(value);
+    });
+    assert(pre_order == std::vector<int>({50, 30, 20, 40, 45, 70, 60, 80}));
+
+    std::vector<int> post_order;
+    compact.post_order_traversal([&post_order](int value) {
+        post_order.push_back(value);
+    });
+    assert(post_order == std::vector<int>({20, 45, 40, 30, 60, 80, 70, 50}));
+
+    auto next = compact.erase(compact.find(50));
+    assert(*next == 60);
+    assert(compact.erase(20) == 1);
+    assert(compact.erase(20) == 0);
+    assert(compact.to_vector() == std::vector<int>({30, 40, 45, 60, 70, 80}));
+    assert(compact.is_valid_bst());
+
+    std::vector<int> descending;
+    for (auto it = compact.end(); it != compact.begin();) {
+        descending.push_back(*--it);
+    }
+    assert(descending == std::vector<int>({80, 70, 60, 45, 40, 30}));
+
+    CompactBinarySearchTree<int> chain;
+    for (int value = 0; value < 1000; ++value) {
+        chain.insert(value);
+    }
+    assert(chain.height() == 1000);
+    chain.rebalance();
+    assert(chain.height() == 10);
+    assert(chain.is_valid_bst());
+
+    CompactBinarySearchTree<int> copy(chain);
+    for (int value = 0; value < 1000; value += 2) {
+        copy.erase(value);
+    }
+    assert(copy.size() == 500);
+    assert(chain.size() == 1000);
+    assert(copy.is_valid_bst());
+
+    CompactBinarySearchTree<std::string> words;
+    words.emplace("pear");
+    words.emplace("apple");
+    words.erase("pear");
+    assert(words.size() == 1);
+    assert(*words.begin() == "apple");
+}
+
+void test_compact_tree_without_parent_links() {
+    using ParentlessTree = CompactBinarySearchTree<int, std::less<int>, bst::parentless_links>;
+
+    ParentlessTree tree = {50, 30, 70, 20, 40, 60, 80};
+    for (int value = 81; value < 200; value += 3) {
+        tree.insert(value);
+    }
+
+    std::vector<int> expected = tree.to_vector();
+    std::vector<int> forward;
+    for (int value : tree) {
+        forward.push_back(value);
+    }
+    assert(forward == expected);
+
+    std::vector<int> backward;
+    for (auto it = tree.end(); it != tree.begin();) {
+        backward.push_back(*--it);
+    }
+    assert(std::vector<int>(backward.rbegin(), backward.rend()) == expected);
+
+    auto it = tree.find(40);
+    ++it;
+    assert(*it == 50);
+    --it;
+    --it;
+    assert(*it == 30);
+
+    auto inserted = tree.insert(45);
+    assert(*++inserted.first == 50);
+
+    auto next = tree.erase(tree.find(50));
+    assert(*next == 60);
+    assert(tree.erase(81) == 1);
+    assert(!tree.contains(50));
+    assert(tree.is_valid_bst());
+
+    std::vector<int> pre_order;
+    tree.pre_order_traversal([&pre_order](int value) {
+        pre_order.push_back(value);
+    });
+    assert(pre_order.size() == tree.size());
+    assert(pre_order.front() == 60);
+
+    for (int value = 0; value < 1000; ++value) {
+        tree.insert(1000 + value);
+    }
+    tree.rebalance();
+    assert(tree.height() == 11);
+    assert(tree.is_valid_bst());
+
+    CompactBinarySearchTree<std::string, std::greater<std::string>, bst::parentless_links> words;
+    for (const char* word : {"delta", "bravo", "foxtrot", "alpha", "charlie", "echo", "golf"}) {
+        words.insert(std::string(word) + " with a value long enough to live on the heap");
+    }
+    words.rebalance();
+    assert(words.height() == 3);
+    assert(words.is_valid_bst());
+    assert(words.begin()->compare(0, 4, "golf") == 0);
+    assert(words.max().compare(0, 5, "alpha") == 0);
+}
+
+void test_threaded_iteration() {
+    using ThreadedTree = BinarySearchTree<int, std::less<int>, bst::threaded<bst::avl_balance>>;
+
+    ThreadedTree tree;
+    for (int value = 0; value < 200; ++value) {
+        tree.insert((value * 37) % 200);
+    }
+    for (int value = 0; value < 200; value += 3) {
+        tree.erase(value);
+    }
+
+    std::vector<int> expected = tree.to_vector();
+    std::vector<int> forward(tree.begin(), tree.end());
+    assert(forward == expected);
+
+    std::vector<int> backward;
+    for (auto it = tree.end(); it != tree.begin();) {
+        backward.push_back(*--it);
+    }
+    assert(std::vector<int>(backward.rbegin(), backward.rend()) == expected);
+
+    auto it = tree.find(100);
+    assert(*++it == 101);
+    assert(*tree.erase(it) == 103);
+
+    ThreadedTree copy(tree);
+    assert(std::vector<int>(copy.begin(), copy.end()) == tree.to_vector());
+
+    using ThreadedTreap = BinarySearchTree<int, std::less<int>, bst::threaded<bst::treap_balance>>;
+    ThreadedTreap lower = {1, 2, 3, 4, 5, 6};
+    ThreadedTreap upper = lower.split(4);
+    assert(std::vector<int>(lower.begin(), lower.end()) == std::vector<int>({1, 2, 3}));
+    assert(std::vector<int>(upper.begin(), upper.end()) == std::vector<int>({4, 5, 6}));
+    lower.join(std::move(upper));
+    assert(std::vector<int>(lower.begin(), lower.end()) == std::vector<int>({1, 2, 3, 4, 5, 6}));
+}
+
+void test_intrusive_tree() {
+    std::vector<Order> orders(50);
+    for (int i = 0; i < 50; ++i) {
+        orders[static_cast<std::size_t>(i)].id = (i * 17) % 50;
+    }
+
+    IntrusiveBinarySearchTree<Order> by_id;
+    by_id.insert(orders.begin(), orders.end());
+    assert(by_id.size() == 50);
+    assert(by_id.is_valid_bst());
+    assert(by_id.min().id == 0);
+    assert(by_id.max().id == 49);
+    Order& smallest = by_id.min();
+    assert(&smallest == &orders[0]);
+    assert(&by_id.max() == &orders[47]);
+    assert(&std::as_const(by_id).min() == &orders[0]);
+
+    Order probe;
+    probe.id = 17;
+    auto found = by_id.find(probe);
+    assert(&*found == &orders[1]);
+    assert(by_id.iterator_to(orders[1]) == found);
+
+    Order duplicate;
+    duplicate.id = 17;
+    auto inserted = by_id.insert(duplicate);
+    assert(!inserted.second);
+    assert(&*inserted.first == &orders[1]);
+
+    auto next = by_id.erase(found);
+    assert(next->id == 18);
+    assert(by_id.erase(probe) == 0);
+    probe.id = 20;
+    assert(by_id.erase(probe) == 1);
+    assert(by_id.size() == 48);
+    assert(!by_id.contains(probe));
+    assert(by_id.lower_bound(probe)->id == 21);
+    assert(by_id.upper_bound(probe)->id == 21);
+
+    int previous = -1;
+    for (const Order& order : by_id) {
+        assert(order.id > previous);
+        previous = order.id;
+    }
+
+    by_id.rebalance();
+    assert(by_id.height() == 6);
+    assert(by_id.is_valid_bst());
+    assert(orders[0].id == 0);
+
+    // Erasing inner nodes splices in their successors without moving objects.
+    for (Order& order : orders) {
+        if (order.id % 3 == 0 && by_id.contains(order)) {
+            const auto after = std::next(by_id.iterator_to(order));
+            assert(by_id.erase(by_id.iterator_to(order)) == after);
+        }
+    }
+    assert(by_id.size() == 31);
+    assert(by_id.is_valid_bst());
+    std::vector<int> pre_order;
+    by_id.pre_order_traversal([&pre_order](const Order& order) {
+        pre_order.push_back(order.id);
+    });
+    std::vector<int> post_order;
+    by_id.post_order_traversal([&post_order](const Order& order) {
+        post_order.push_back(order.id);
+    });
+    assert(pre_order.size() == 31);
+    assert(post_order.size() == 31);
+    assert(pre_order.front() == post_order.back());
+
+    std::vector<Session> sessions(3);
+    sessions[0].id = 30;
+    sessions[1].id = 10;
+    sessions[2].id = 20;
+
+    IntrusiveBinarySearchTree<Session, SessionById, bst::member_hook<Session, &Session::by_id>> by_session;
+    for (Session& session : sessions) {
+        by_session.insert(session);
+    }
+
+    std::vector<int> ids;
+    for (const Session& session : by_session) {
+        ids.push_back(session.id);
+    }
+    assert(ids == std::vector<int>({10, 20, 30}));
+
+    auto moved = std::move(by_session);
+    assert(by_session.empty());
+    assert(moved.size() == 3);
+    moved.clear();
+    assert(moved.empty());
+    assert(sessions[0].id == 30);
+}
+
+void test_node_handles() {
+    using Tree = BinarySearchTree<std::string, std::less<std::string>, bst::red_black_balance>;
+
+    Tree today = {"alpha", "bravo", "charlie", "delta"};
+    Tree archive;
+
+    const std::string* address = &*today.find("bravo");
+    Tree::node_type handle = today.extract("bravo");
+    assert(!handle.empty());
+    assert(&handle.value() == address);
+    assert(today.size() == 3);
+    assert(!today.contains("bravo"));
+
+    auto result = archive.insert(std::move(handle));
+    assert(result.inserted);
+    assert(result.node.empty());
+    assert(&*result.position == address);
+    assert(archive.contains("bravo"));
+
+    Tree::node_type renamed = today.extract(today.begin());
+    assert(renamed.value() == "alpha");
+    renamed.value() = "zulu";
+    today.insert(std::move(renamed));
+    assert(today.to_vector() == std::vector<std::string>({"charlie", "delta", "zulu"}));
+
+    archive.insert("charlie");
+    auto duplicate = archive.insert(today.extract("charlie"));
+    assert(!duplicate.inserted);
+    assert(!duplicate.node.empty());
+    assert(duplicate.node.value() == "charlie");
+    assert(*duplicate.position == "charlie");
+
+    assert(today.extract("missing").empty());
+    assert(today.extract(today.end()).empty());
+    assert(!archive.insert(Tree::node_type()).inserted);
+    assert(today.is_valid_bst());
+    assert(archive.is_valid_bst());
+}
+
+void test_merge_splices_nodes() {
+    using Tree = BinarySearchTree<int, std::less<int>, bst::avl_balance>;
+
+    Tree large;
+    for (int value = 0; value < 100; value += 2) {
+        large.insert(value);
+    }
+
+    Tree small = {1, 3, 4, 5};
+    const int* address = &*small.find(3);
+    large.merge(small);
+    assert(large.size() == 53);
+    assert(&*large.find(3) == address);
+    assert(small.to_vector() == std::vector<int>({4}));
+    assert(large.is_valid_bst());
+
+    Tree other;
+    for (int value = 0; value < 200; value += 3) {
+        other.insert(value);
+    }
+    large.merge(other);
+    for (int value : other) {
+        assert(large.contains(value));
+        assert(value % 2 == 0 || value < 6);
+    }
+    assert(large.size() + other.size() == 53 + 67);
+    assert(large.height() <= 8);
+    assert(large.is_valid_bst());
+    assert(other.is_valid_bst());
+
+    Tree empty;
+    empty.merge(Tree{7, 8});
+    assert(empty.to_vector() == std::vector<int>({7, 8}));
+}
+
+void test_clear_degenerate_tree() {
+    // Sorted splay inserts leave a single left-leaning path of N nodes, which
+    // recursive teardown would follow one stack frame per node.
+    using SplayTree = BinarySearchTree<int, std::less<int>, bst::splay_balance>;
+
+    SplayTree chain;
+    for (int value = 0; value < 1000000; ++value) {
+        chain.insert(value);
+    }
+    chain.clear();
+    assert(chain.empty());
+
+    {
+        SplayTree scoped;
+        for (int value = 0; value < 1000000; ++value) {
+            scoped.insert(value);
+        }
+    }
+
+    chain.insert(1);
+    assert(chain.size() == 1);
+}
+
+void test_copy_degenerate_tree() {
+    using SplayTree = BinarySearchTree<int, std::less<int>, bst::splay_balance>;
+
+    SplayTree chain;
+    for (int value = 0; value < 1000000; ++value) {
+        chain.insert(value);
+    }
+
+    SplayTree copy(chain);
+    assert(copy.size() == chain.size());
+    assert(copy.min() == 0);
+    assert(copy.max() == 999999);
+
+    using PooledTree = BinarySearchTree<int, std::less<int>, bst::avl_balance, bst::pool_allocator<int>>;
+    PooledTree pooled = {5, 1, 9, 3, 7};
+    PooledTree pooled_copy(pooled);
+    assert(pooled_copy.to_vector() == pooled.to_vector());
+    assert(pooled.get_allocator().in_use() == 10);
+}
+
+void test_traversals_on_degenerate_tree() {
+    using SplayTree = BinarySearchTree<int, std::less<int>, bst::splay_balance>;
+
+    const int count = 1000000;
+    SplayTree chain;
+    for (int value = 0; value < count; ++value) {
+        chain.insert(value);
+    }
+
+    assert(chain.height() == static_cast<std::size_t>(count));
+    assert(chain.is_valid_bst());
+
+    long long expected = 0;
+    int in_order_previous = -1;
+    bool in_order_sorted = true;
+    chain.in_order_traversal([&](int value) {
+        in_order_sorted = in_order_sorted && value == in_order_previous + 1;
+        in_order_previous = value;
+        expected += value;
+    });
+    assert(in_order_sorted);
+
+    int pre_order_first = -1;
+    long long pre_order_sum = 0;
+    chain.pre_order_traversal([&](int value) {
+        if (pre_order_first < 0) {
+            pre_order_first = value;
+        }
+        pre_order_sum += value;
+    });
+    assert(pre_order_first == count - 1);
+    assert(pre_order_sum == expected);
+
+    int post_order_last = -1;
+    chain.post_order_traversal([&](int value) {
+        post_order_last = value;
+    });
+    assert(post_order_last == count - 1);
+}
+
+void test_early_exit_and_range_visits() {
+    BinarySearchTree<int> tree;
+    for (int value = 0; value < 100; ++value) {
+        tree.insert((value * 37) % 100);
+    }
+
+    int first_match = -1;
+    int visited = 0;
+    tree.in_order_traversal([&](int value) {
+        ++visited;
+        if (value > 10 && value % 7 == 0) {
+            first_match = value;
+            return bst::visit::stop;
+        }
+        return bst::visit::proceed;
+    });
+    assert(first_match == 14);
+    assert(visited == 15);
+
+    visited = 0;
+    tree.pre_order_traversal([&](int) {
+        ++visited;
+        return bst::visit::stop;
+    });
+    assert(visited == 1);
+
+    std::vector<int> in_range;
+    tree.for_each_in_range(20, 25, [&](int value) {
+        in_range.push_back(value);
+    });
+    assert((in_range == std::vector<int>{20, 21, 22, 23, 24}));
+
+    in_range.clear();
+    tree.for_each_in_range(40, 30, [&](int value) {
+        in_range.push_back(value);
+    });
+    assert(in_range.empty());
+
+    in_range.clear();
+    tree.for_each_in_range(95, 1000, [&](int value) {
+        in_range.push_back(value);
+        return in_range.size() == 3 ? bst::visit::stop : bst::visit::proceed;
+    });
+    assert((in_range == std::vector<int>{95, 96, 97}));
+
+    BinarySearchTree<int, std::less<int>, bst::threaded<bst::avl_balance>> threaded_tree = {5, 1, 9, 3, 7};
+    in_range.clear();
+    threaded_tree.for_each_in_range(2, 9, [&](int value) {
+        in_range.push_back(value);
+    });
+    assert((in_range == std::vector<int>{3, 5, 7}));
+
+    BinarySearchTree<int> chain;
+    for (int value = 1000; value > 0; --value) {
+        chain.insert(value);
+    }
+    long long sum = 0;
+    chain.for_each_in_range(100, 901, [&](int value) {
+        sum += value;
+    });
+    assert(sum == 400500);
+}
+
+void test_order_statistics() {
+    using RankedTree = BinarySearchTree<int, std::less<int>, bst::order_statistics<bst::red_black_balance>>;
+
+    RankedTree tree;
+    for (int value = 0; value < 1000; ++value) {
+        tree.insert((value * 7) % 1000);
+    }
+    for (int value = 0; value < 1000; value += 2) {
+        tree.erase(value);
+    }
+    assert(tree.size() == 500);
+    assert(tree.is_valid_bst());
+
+    assert(*tree.nth(0) == 1);
+    assert(*tree.nth(49) == 99);
+    assert(*tree.nth(499) == 999);
+    assert(tree.nth(500) == tree.end());
+
+    assert(tree.rank(1) == 0);
+    assert(tree.rank(100) == 50);
+    assert(tree.rank(101) == 50);
+    assert(tree.rank(5000) == 500);
+
+    const RankedTree& view = tree;
+    const auto p99 = view.nth(view.size() * 99 / 100);
+    assert(*p99 == 991);
+    assert(view.distance(view.begin(), p99) == 495);
+    assert(view.distance(p99, view.end()) == 5);
+    assert(view.distance(view.end(), view.begin()) == -500);
+
+    RankedTree copy(tree);
+    copy.insert(0);
+    assert(*copy.nth(0) == 0);
+    assert(*copy.nth(1) == 1);
+    assert(copy.rank(3) == 2);
+
+    using Treap = BinarySearchTree<int, std::less<int>, bst::treap_balance>;
+    Treap treap = {40, 10, 30, 20};
+    assert(*treap.nth(2) == 30);
+    assert(treap.rank(25) == 2);
+
+    using ThreadedRankedTree =
+        BinarySearchTree<int, std::less<int>, bst::threaded<bst::order_statistics<bst::avl_balance>>>;
+    ThreadedRankedTree threaded_tree = {5, 1, 9, 3, 7};
+    assert(*threaded_tree.nth(3) == 7);
+    assert(threaded_tree.rank(9) == 4);
+}
+
+void test_count_in_range() {
+    using RankedTree = BinarySearchTree<int, std::less<int>, bst::order_statistics<bst::avl_balance>>;
+
+    RankedTree ranked;
+    BinarySearchTree<int> plain;
+    for (int value = 0; value < 300; value += 3) {
+        ranked.insert(value);
+        plain.insert(value);
+    }
+
+    assert(ranked.count_in_range(0, 300) == 100);
+    assert(ranked.count_in_range(10, 20) == 3);
+    assert(ranked.count_in_range(9, 21) == 4);
+    assert(ranked.count_in_range(-50, 1) == 1);
+    assert(ranked.count_in_range(298, 1000) == 0);
+    assert(ranked.count_in_range(20, 10) == 0);
+    assert(ranked.count_in_range(15, 15) == 0);
+
+    for (int lo = -5; lo < 305; lo += 7) {
+        for (int hi = lo; hi < 310; hi += 11) {
+            assert(ranked.count_in_range(lo, hi) == plain.count_in_range(lo, hi));
+        }
+    }
+
+    ranked.erase(12);
+    assert(ranked.count_in_range(10, 20) == 2);
+}
+
+void test_range_aggregates() {
+    using OrderBook = BinarySearchTree<PriceLevel, std::less<PriceLevel>, bst::augmented<QuantitySum, bst::avl_balance>>;
+
+    OrderBook book;
+    assert(book.aggregate() == 0);
+    for (int price = 100; price < 200; ++price) {
+        book.insert(PriceLevel{price, price - 99});
+    }
+    assert(book.aggregate() == 5050);
+    assert(book.aggregate(PriceLevel{100}, PriceLevel{110}) == 55);
+    assert(book.aggregate(PriceLevel{150}, PriceLevel{151}) == 51);
+    assert(book.aggregate(PriceLevel{0}, PriceLevel{1000}) == 5050);
+    assert(book.aggregate(PriceLevel{120}, PriceLevel{120}) == 0);
+    assert(book.aggregate(PriceLevel{300}, PriceLevel{400}) == 0);
+
+    book.erase(PriceLevel{105});
+    assert(book.aggregate(PriceLevel{100}, PriceLevel{110}) == 49);
+    auto level = book.extract(PriceLevel{106});
+    level.value().quantity = 1000;
+    book.insert(std::move(level));
+    assert(book.aggregate(PriceLevel{100}, PriceLevel{110}) == 1042);
+    assert(book.aggregate() == 5050 - 6 + 1000 - 7);
+
+    OrderBook copy(book);
+    copy.clear();
+    assert(copy.aggregate() == 0);
+    assert(book.aggregate(PriceLevel{100}, PriceLevel{110}) == 1042);
+
+    // Non-commutative aggregates are combined in sorted order.
+    using DigitTree = BinarySearchTree<int, std::less<int>, bst::augmented<Digits, bst::red_black_balance>>;
+    DigitTree digits;
+    for (int value : {5, 2, 8, 1, 9, 3, 7, 4, 6}) {
+        digits.insert(value);
+    }
+    assert(digits.aggregate() == "123456789");
+    assert(digits.aggregate(3, 8) == "34567");
+    digits.erase(5);
+    assert(digits.aggregate(3, 8) == "3467");
+}
+
+void test_interval_tree() {
+    using Interval = std::pair<int, int>;
+    using Schedule = bst::IntervalTree<Interval>;
+
+    Schedule schedule = {{0, 10}, {5, 8}, {9, 20}, {12, 15}, {14, 30}, {25, 26}, {40, 50}};
+    assert(schedule.is_valid_bst());
+
+    const auto starts = [](const std::vector<Schedule::const_iterator>& matches) {
+        std::vector<int> result;
+        for (const auto& match : matches) {
+            result.push_back(match->first);
+        }
+        return result;
+    };
+
+    assert((starts(schedule.overlapping(7)) == std::vector<int>{0, 5}));
+    assert((starts(schedule.overlapping(10)) == std::vector<int>{9}));
+    assert((starts(schedule.overlapping(14)) == std::vector<int>{9, 12, 14}));
+    assert(schedule.overlapping(35).empty());
+    assert(schedule.overlapping(50).empty());
+
+    assert((starts(schedule.overlapping(8, 13)) == std::vector<int>{0, 9, 12}));
+    assert((starts(schedule.overlapping(26, 41)) == std::vector<int>{14, 40}));
+    assert(schedule.overlapping(30, 40).empty());
+    assert(schedule.overlapping(20, 20).empty());
+
+    int visited = 0;
+    schedule.for_each_overlapping(0, 100, [&visited](const Interval&) {
+        ++visited;
+        return visited == 3 ? bst::visit::stop : bst::visit::proceed;
+    });
+    assert(visited == 3);
+
+    for (const auto& match : schedule.overlapping(14)) {
+        schedule.erase(match);
+    }
+    assert(schedule.size() == 4);
+    assert((starts(schedule.overlapping(7, 30)) == std::vector<int>{0, 5, 25}));
+
+    schedule.insert({-5, 100});
+    assert((starts(schedule.overlapping(35)) == std::vector<int>{-5}));
+
+    BinarySearchTree<Interval, std::less<Interval>, bst::augmented<bst::max_upper_endpoint<Interval>>> chain;
+    for (int start = 0; start < 500; ++start) {
+        chain.insert({start, start % 100 == 0 ? 1000 : start + 1});
+    }
+    assert(chain.overlapping(450).size() == 6);
+    assert(chain.overlapping(0, 1).size() == 1);
+}